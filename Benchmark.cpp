@@ -0,0 +1,395 @@
+// Microbenchmarks for the headless engine: board generation, adjacency, opening reveal,
+// win checking and full scripted games, across board sizes and mine densities.
+// Results are written as JSON so runs can be compared between builds.
+#include "BoardGenerator.h"
+#include "EndlessEngine.h"
+#include "GameEngine.h"
+#include "Replay.h"
+#include "ScoreFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+struct BoardSize {
+    int columns;
+    int rows;
+};
+
+struct Options {
+    vector<BoardSize> sizes;
+    vector<double> densities;
+    double minSeconds = 0.25; // Keep repeating a case until this much time was measured
+    int minRepetitions = 3;
+    int maxRepetitions = 1000;
+    string outputFile;        // stdout if empty
+    uint64_t seed = 1;        // Engine boards are generated from this seed on, so runs are reproducible
+    string replayFile;        // Recorded games to play back as a workload, none if empty
+    int scoreLines = 1000000; // Lines of the generated leaderboard file to parse, 0 to skip
+};
+
+struct Result {
+    string name;
+    int columns;
+    int rows;
+    int mines;
+    double density;
+    int repetitions;
+    double meanNs;
+    double minNs;
+    double maxNs;
+    // Sparse board cases only: cells revealed, and bytes per revealed cell for the chunked
+    // board and for a dense board covering the same explored rectangle
+    std::uint64_t revealedCells;
+    double bytesPerRevealedCell;
+    double denseBytesPerRevealedCell;
+    // Leaderboard file cases only: lines per parse
+    std::uint64_t lines;
+};
+
+// Runs `setup` (untimed) and `body` (timed) until enough time or repetitions were collected.
+// Wall time including setup is capped too, so an expensive setup cannot stretch a tiny case.
+static Result measure(const Options& options, const string& name, int columns, int rows, int mines, double density,
+                      const function<void()>& setup, const function<void()>& body) {
+    Result result = {name, columns, rows, mines, density, 0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0};
+    double totalNs = 0.0;
+    Clock::time_point wallStart = Clock::now();
+
+    while (result.repetitions < options.maxRepetitions &&
+           (result.repetitions < options.minRepetitions ||
+            (totalNs < options.minSeconds * 1e9 &&
+             chrono::duration<double>(Clock::now() - wallStart).count() < options.minSeconds * 4))) {
+        setup();
+        Clock::time_point start = Clock::now();
+        body();
+        double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+
+        result.minNs = result.repetitions == 0 ? ns : min(result.minNs, ns);
+        result.maxNs = max(result.maxNs, ns);
+        totalNs += ns;
+        ++result.repetitions;
+    }
+    result.meanNs = totalNs / result.repetitions;
+    return result;
+}
+
+static void runBoard(const Options& options, BoardSize size, double density, vector<Result>& results) {
+    int cells = size.columns * size.rows;
+    int mines = min(max(static_cast<int>(cells * density + 0.5), 1), cells - 1); // Keep at least one safe cell
+
+    fprintf(stderr, "%dx%d, %d mines\n", size.columns, size.rows, mines);
+
+    // Board generation steps on their own
+    Board board(size.columns, size.rows);
+    vector<int> minePositions;
+    uint64_t seed = 0;
+    results.push_back(measure(options, "place_mines", size.columns, size.rows, mines, density,
+        [&] { board.clear(); },
+        [&] { placeMines(board, mines, ++seed, minePositions); }));
+    results.push_back(measure(options, "adjacent_mines", size.columns, size.rows, mines, density,
+        [] {},
+        [&] { calculateAdjacentMines(board); }));
+
+    // The reference loop, for comparison (BoardGeneratorTest checks that both agree)
+    Board reference = board;
+    results.push_back(measure(options, "adjacent_mines_scalar", size.columns, size.rows, mines, density,
+        [] {},
+        [&] { calculateAdjacentMinesScalar(reference); }));
+
+    // Opening reveal: click the first zero cell of a fresh board
+    GameEngine engine(size.columns, size.rows, mines, options.seed);
+    int openingRow = -1, openingCol = -1;
+    results.push_back(measure(options, "opening_reveal", size.columns, size.rows, mines, density,
+        [&] {
+            engine.reset();
+            openingRow = -1;
+            const Board& state = engine.getBoard();
+            for (int index = 0; index < state.size(); ++index) {
+                if (!state[index].isMine() && state[index].adjacentMines() == 0) {
+                    openingRow = state.rowOf(index);
+                    openingCol = state.colOf(index);
+                    break;
+                }
+            }
+        },
+        [&] {
+            if (openingRow >= 0) engine.reveal(openingRow, openingCol);
+        }));
+
+    // Win checking, averaged over many calls since a single one is far below clock resolution
+    // (the volatile pointer and result keep the query from being hoisted out of the loop)
+    const int winChecks = 1000000;
+    const GameEngine* volatile checkedEngine = &engine;
+    volatile bool won = false;
+    Result winCheck = measure(options, "win_check", size.columns, size.rows, mines, density,
+        [] {},
+        [&] {
+            for (int i = 0; i < winChecks; ++i) {
+                won = checkedEngine->isWon();
+            }
+        });
+    winCheck.meanNs /= winChecks;
+    winCheck.minNs /= winChecks;
+    winCheck.maxNs /= winChecks;
+    results.push_back(winCheck);
+
+    // Scripted game: reveal every safe cell and flag every mine, in a fixed shuffled order
+    vector<int> order(cells);
+    for (int i = 0; i < cells; ++i) order[i] = i;
+    shuffle(order.begin(), order.end(), mt19937(12345));
+    results.push_back(measure(options, "scripted_game", size.columns, size.rows, mines, density,
+        [&] { engine.reset(); },
+        [&] {
+            const Board& state = engine.getBoard();
+            for (int index : order) {
+                if (engine.isOver()) break;
+                Cell cell = state[index];
+                if (cell.isMine()) {
+                    engine.toggleFlag(state.rowOf(index), state.colOf(index));
+                } else if (!cell.isRevealed()) {
+                    engine.reveal(state.rowOf(index), state.colOf(index));
+                }
+            }
+        }));
+}
+
+// Explores an unbounded board the way an endless game does: clicks wander outward from the
+// origin in small random steps, every safe cell they land on is revealed and its openings are
+// followed up to the flood limit. Only the explored area should cost memory.
+static void runEndless(const Options& options, double density, vector<Result>& results) {
+    const uint64_t target = 200000; // Revealed cells per run
+    fprintf(stderr, "endless, density %.2f\n", density);
+
+    unique_ptr<EndlessEngine> engine;
+    int64_t top = 0, bottom = 0, left = 0, right = 0; // Explored rectangle
+    Result result = measure(options, "endless_explore", 0, 0, 0, density,
+        [&] {
+            engine.reset(new EndlessEngine(density, options.seed));
+            top = bottom = left = right = 0;
+        },
+        [&] {
+            mt19937 random(12345);
+            uniform_int_distribution<int> step(-16, 16);
+            int64_t row = 0, col = 0;
+            ChunkedBoard& board = engine->getBoard();
+            for (int clicks = 0; engine->getRevealedCount() < target && clicks < 10000000; ++clicks) {
+                // A perfect player: mines are skipped rather than lost on
+                if (clicks > 0) {
+                    row += step(random);
+                    col += step(random);
+                }
+                if (board.isMine(row, col) || board.isRevealed(row, col)) continue;
+
+                bool changed = engine->reveal(row, col);
+                while (changed) {
+                    for (const EndlessEngine::Position& cell : engine->getChangedCells()) {
+                        top = min(top, cell.row);
+                        bottom = max(bottom, cell.row);
+                        left = min(left, cell.col);
+                        right = max(right, cell.col);
+                    }
+                    changed = engine->getRevealedCount() < target && engine->continueOpening();
+                }
+            }
+        });
+
+    ChunkedBoard& board = engine->getBoard();
+    double revealed = static_cast<double>(engine->getRevealedCount());
+    result.revealedCells = engine->getRevealedCount();
+    result.bytesPerRevealedCell = board.getMemoryUsage() / revealed;
+    result.denseBytesPerRevealedCell = (bottom - top + 1) * static_cast<double>(right - left + 1) / revealed;
+    fprintf(stderr, "  %llu cells revealed, %zu chunks (%zu written), %.2f bytes per revealed cell, %.2f dense\n",
+            static_cast<unsigned long long>(result.revealedCells), board.getChunkCount(), board.getWrittenChunkCount(),
+            result.bytesPerRevealedCell, result.denseBytesPerRevealedCell);
+    results.push_back(result);
+}
+
+// Imports a generated leaderboard file the way the game does: map it and scan every line in
+// place. One line in a hundred is malformed, so skipping and counting those is measured too.
+static void runScoreFile(const Options& options, vector<Result>& results) {
+    const char* file = "bench_scores.txt";
+    FILE* output = fopen(file, "wb");
+    if (!output) {
+        fprintf(stderr, "Failed to write %s\n", file);
+        exit(1);
+    }
+    mt19937 random(static_cast<uint32_t>(options.seed));
+    size_t wellFormed = 0, malformed = 0;
+    for (int i = 0; i < options.scoreLines; ++i) {
+        unsigned minutes = random() % 100, seconds = random() % 60, player = random() % 100000;
+        if (random() % 100 == 0) {
+            fprintf(output, "%02u:%02u\n", minutes, seconds); // No name
+            ++malformed;
+        } else {
+            fprintf(output, "%02u:%02u,player%u\n", minutes, seconds, player);
+            ++wellFormed;
+        }
+    }
+    fclose(output);
+    fprintf(stderr, "score file, %d lines\n", options.scoreLines);
+
+    ScoreFile scores;
+    vector<ScoreFile::Record> records;
+    records.reserve(wellFormed);
+    bool valid = true;
+    Result result = measure(options, "score_file_parse", 0, 0, 0, 0.0,
+        [&] { records.clear(); },
+        [&] {
+            valid = scores.open(file) && scores.parse(records) == wellFormed && scores.getMalformedCount() == malformed &&
+                    valid;
+            scores.close();
+        });
+    remove(file);
+    if (!valid) {
+        fprintf(stderr, "The generated score file did not parse as written\n");
+        exit(1);
+    }
+    result.lines = options.scoreLines;
+    results.push_back(result);
+}
+
+// Plays every recorded game back, each one has to end exactly as it was recorded
+static void runReplays(const Options& options, vector<Result>& results) {
+    vector<Replay> replays;
+    if (!Replay::load(options.replayFile, replays) || replays.empty()) {
+        fprintf(stderr, "Failed to load replays from %s\n", options.replayFile.c_str());
+        exit(1);
+    }
+    fprintf(stderr, "%zu replays from %s\n", replays.size(), options.replayFile.c_str());
+
+    const Replay& first = replays.front();
+    bool valid = true;
+    results.push_back(measure(options, "replay_playback", first.getColumns(), first.getRows(), first.getMines(), 0.0,
+        [] {},
+        [&] {
+            for (const Replay& replay : replays) {
+                valid = replay.verify() && valid;
+            }
+        }));
+    if (!valid) {
+        fprintf(stderr, "Replays in %s no longer end as recorded\n", options.replayFile.c_str());
+        exit(1);
+    }
+}
+
+static void writeJson(FILE* output, const vector<Result>& results) {
+    fprintf(output, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        // Sparse boards have no fixed size, their rate is in revealed cells
+        double cells = r.revealedCells > 0 ? static_cast<double>(r.revealedCells) : static_cast<double>(r.columns) * r.rows;
+        fprintf(output,
+                "    {\"name\": \"%s\", \"columns\": %d, \"rows\": %d, \"mines\": %d, \"density\": %.2f, "
+                "\"repetitions\": %d, \"mean_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, "
+                "\"cells_per_second\": %.0f",
+                r.name.c_str(), r.columns, r.rows, r.mines, r.density, r.repetitions, r.meanNs, r.minNs, r.maxNs,
+                r.meanNs > 0 ? cells / (r.meanNs * 1e-9) : 0.0);
+        if (r.revealedCells > 0) {
+            fprintf(output, ", \"revealed_cells\": %llu, \"bytes_per_revealed_cell\": %.3f, "
+                            "\"dense_bytes_per_revealed_cell\": %.3f",
+                    static_cast<unsigned long long>(r.revealedCells), r.bytesPerRevealedCell, r.denseBytesPerRevealedCell);
+        }
+        if (r.lines > 0) {
+            fprintf(output, ", \"lines\": %llu, \"lines_per_second\": %.0f", static_cast<unsigned long long>(r.lines),
+                    r.meanNs > 0 ? r.lines / (r.meanNs * 1e-9) : 0.0);
+        }
+        fprintf(output, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(output, "  ]\n}\n");
+}
+
+static vector<BoardSize> parseSizes(const string& text) {
+    vector<BoardSize> sizes;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        BoardSize size;
+        if (sscanf(item.c_str(), "%dx%d", &size.columns, &size.rows) == 2 && size.columns > 0 && size.rows > 0) {
+            sizes.push_back(size);
+        }
+    }
+    return sizes;
+}
+
+static vector<double> parseDensities(const string& text) {
+    vector<double> densities;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        double density = atof(item.c_str());
+        if (density > 0.0 && density < 1.0) densities.push_back(density);
+    }
+    return densities;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.sizes = parseSizes("9x9,16x16,30x16,64x64,256x256,1024x1024,4096x4096");
+    options.densities = parseDensities("0.01,0.1,0.2,0.5,0.9");
+
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--sizes" && hasValue) {
+            options.sizes = parseSizes(argv[++i]);
+        } else if (option == "--densities" && hasValue) {
+            options.densities = parseDensities(argv[++i]);
+        } else if (option == "--min-time" && hasValue) {
+            options.minSeconds = atof(argv[++i]);
+        } else if (option == "--max-repetitions" && hasValue) {
+            options.maxRepetitions = max(1, atoi(argv[++i]));
+        } else if (option == "--seed" && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--replays" && hasValue) {
+            options.replayFile = argv[++i];
+        } else if (option == "--score-lines" && hasValue) {
+            options.scoreLines = max(0, atoi(argv[++i]));
+        } else if (option == "--output" && hasValue) {
+            options.outputFile = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--sizes 9x9,30x16,...] [--densities 0.01,0.2,...] [--min-time seconds]\n"
+                    "          [--max-repetitions n] [--seed n] [--replays games.msr] [--score-lines n]\n"
+                    "          [--output results.json]\n",
+                    argv[0]);
+            return option == "--help" ? 0 : 1;
+        }
+    }
+
+    vector<Result> results;
+    for (const BoardSize& size : options.sizes) {
+        for (double density : options.densities) {
+            runBoard(options, size, density, results);
+        }
+    }
+    // Endless boards are only playable at low densities
+    for (double density : options.densities) {
+        if (density <= 0.2) runEndless(options, density, results);
+    }
+    if (options.scoreLines > 0) {
+        runScoreFile(options, results);
+    }
+    if (!options.replayFile.empty()) {
+        runReplays(options, results);
+    }
+
+    FILE* output = options.outputFile.empty() ? stdout : fopen(options.outputFile.c_str(), "w");
+    if (!output) {
+        fprintf(stderr, "Failed to open %s\n", options.outputFile.c_str());
+        return 1;
+    }
+    writeJson(output, results);
+    if (output != stdout) fclose(output);
+    return 0;
+}
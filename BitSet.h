@@ -0,0 +1,75 @@
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Number of set bits, using the compiler builtin where there is one
+inline int popCount(std::uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Index of the lowest set bit, x must not be zero
+inline int lowestBit(std::uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int index = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// One bit per cell, packed into 64-bit words so set operations and scans run a word at a time
+class BitSet {
+public:
+    BitSet() {}
+    explicit BitSet(int size) { resize(size); }
+
+    void resize(int size) { // Also clears every bit
+        bits = size;
+        words.assign((size + 63) / 64, 0);
+    }
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+    int size() const { return bits; }
+
+    bool test(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+    void set(int index) { words[index >> 6] |= std::uint64_t(1) << (index & 63); }
+    void reset(int index) { words[index >> 6] &= ~(std::uint64_t(1) << (index & 63)); }
+
+    int count() const {
+        int total = 0;
+        for (std::uint64_t word : words) total += popCount(word);
+        return total;
+    }
+
+    // Calls f(index) for every set bit, in increasing order
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (std::uint64_t word = words[w]; word; word &= word - 1) {
+                f(static_cast<int>(w * 64) + lowestBit(word));
+            }
+        }
+    }
+
+    std::vector<std::uint64_t>& getWords() { return words; }
+    const std::vector<std::uint64_t>& getWords() const { return words; }
+
+private:
+    int bits = 0;
+    std::vector<std::uint64_t> words;
+};
+
+#endif // BIT_SET_H
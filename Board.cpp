@@ -0,0 +1,12 @@
+#include "Board.h"
+#include <algorithm>
+
+static_assert(sizeof(Cell) == 1, "Cell must stay packed into a single byte");
+
+Board::Board(int columns, int rows)
+    : columns(columns), rows(rows), cells(static_cast<size_t>(columns) * rows) {
+}
+
+void Board::clear() {
+    std::fill(cells.begin(), cells.end(), Cell());
+}
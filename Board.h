@@ -0,0 +1,58 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstdint>
+#include <vector>
+
+// One board cell packed into a single byte:
+//   bit 0 mine, bit 1 revealed, bit 2 flagged, bits 4-7 adjacent mine count
+struct Cell {
+    static const std::uint8_t MINE = 0x01;
+    static const std::uint8_t REVEALED = 0x02;
+    static const std::uint8_t FLAGGED = 0x04;
+    static const int COUNT_SHIFT = 4;
+
+    std::uint8_t bits = 0;
+
+    bool isMine() const { return (bits & MINE) != 0; }
+    bool isRevealed() const { return (bits & REVEALED) != 0; }
+    bool isFlagged() const { return (bits & FLAGGED) != 0; }
+    int adjacentMines() const { return bits >> COUNT_SHIFT; }
+
+    void set(std::uint8_t flag) { bits |= flag; }
+    void clear(std::uint8_t flag) { bits &= ~flag; }
+    void toggle(std::uint8_t flag) { bits ^= flag; }
+    void setAdjacentMines(int count) { bits = (bits & 0x0F) | (count << COUNT_SHIFT); }
+};
+
+// Flat row-major grid of packed cells, one contiguous allocation for the whole board
+class Board {
+public:
+    Board(int columns, int rows);
+
+    int getColumns() const { return columns; }
+    int getRows() const { return rows; }
+    int size() const { return columns * rows; }
+
+    int index(int row, int col) const { return row * columns + col; }
+    int rowOf(int index) const { return index / columns; }
+    int colOf(int index) const { return index % columns; }
+    bool inBounds(int row, int col) const { return row >= 0 && row < rows && col >= 0 && col < columns; }
+
+    Cell& operator[](int index) { return cells[index]; }
+    const Cell& operator[](int index) const { return cells[index]; }
+    Cell& at(int row, int col) { return cells[index(row, col)]; }
+    const Cell& at(int row, int col) const { return cells[index(row, col)]; }
+
+    void clear(); // Every cell back to hidden, unflagged, no mine
+
+    const Cell* data() const { return cells.data(); }
+    Cell* data() { return cells.data(); }
+
+private:
+    int columns;
+    int rows;
+    std::vector<Cell> cells;
+};
+
+#endif // BOARD_H
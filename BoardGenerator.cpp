@@ -0,0 +1,249 @@
+#include "BoardGenerator.h"
+#include "Random.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MINESWEEPER_AVX2_DISPATCH 1 // AVX2 kernel compiled in, used if the CPU has it
+#include <immintrin.h>
+#endif
+
+// Boards at least this large count their rows on several threads
+static const size_t PARALLEL_CELLS = 1 << 20;
+
+// Maps an index among the allowed cells to the board index, skipping the sorted excluded cells
+static int allowedCell(int index, const std::vector<int>& excluded) {
+    for (int cell : excluded) {
+        if (cell > index) break;
+        ++index;
+    }
+    return index;
+}
+
+void placeMines(Board& board, int mines, std::uint64_t seed, std::vector<int>& minePositions,
+                const std::vector<int>& excluded) {
+    Random random(seed);
+    int cells = board.size() - static_cast<int>(excluded.size()); // Cells that may hold a mine
+    mines = std::min(std::max(mines, 0), cells);
+
+    minePositions.clear();
+    minePositions.reserve(mines);
+
+    // Floyd's sampling: one random draw per mine, no retries however dense the board is.
+    // The board's own mine bits serve as the "already chosen" set.
+    for (int j = cells - mines; j < cells; ++j) {
+        int candidate = allowedCell(static_cast<int>(random.below(static_cast<std::uint32_t>(j) + 1)), excluded);
+        int last = allowedCell(j, excluded);
+        int chosen = board[candidate].isMine() ? last : candidate;
+        board[chosen].set(Cell::MINE);
+        minePositions.push_back(chosen);
+    }
+}
+
+// The kernel works on a copy of the mine bits with a one-cell border of zeros (one byte per
+// cell), so every cell has all eight neighbours and the inner loops need no bounds checks.
+// A neighbour count is the sum of three vertically added rows at columns c-1, c and c+1,
+// minus the cell itself. Counts fit in the high nibble of a Cell, mines keep a count of 0.
+namespace {
+
+struct MinePlane {
+    int columns;
+    int rows;
+    int stride;                 // Padded row length, with room for vector loads past the last column
+    std::unique_ptr<std::uint8_t[]> bytes; // Only the border is zeroed, fillRows writes the rest
+
+    const std::uint8_t* row(int r) const { return bytes.get() + static_cast<size_t>(r + 1) * stride; }
+};
+
+inline std::uint8_t packCount(std::uint8_t bits, int count) {
+    // Mines keep a count of 0, like the reference loop leaves them
+    return (bits & Cell::MINE) ? bits : static_cast<std::uint8_t>((bits & 0x0F) | (count << Cell::COUNT_SHIFT));
+}
+
+// Scalar version of the kernel, used for row tails and on platforms without SSE2
+void countRowScalar(const MinePlane& plane, Cell* out, int r, int first) {
+    const std::uint8_t* up = plane.row(r - 1);
+    const std::uint8_t* mid = plane.row(r);
+    const std::uint8_t* down = plane.row(r + 1);
+    for (int c = first; c < plane.columns; ++c) {
+        int count = up[c] + up[c + 1] + up[c + 2] + mid[c] + mid[c + 2] + down[c] + down[c + 1] + down[c + 2];
+        out[c].bits = packCount(out[c].bits, count);
+    }
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+// 16 cells per step
+void countRowSse2(const MinePlane& plane, Cell* out, int r) {
+    const std::uint8_t* up = plane.row(r - 1);
+    const std::uint8_t* mid = plane.row(r);
+    const std::uint8_t* down = plane.row(r + 1);
+    std::uint8_t* cells = reinterpret_cast<std::uint8_t*>(out);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+
+    int c = 0;
+    for (; c + 16 <= plane.columns; c += 16) {
+        __m128i left = _mm_add_epi8(_mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + c)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + c))),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + c)));
+        __m128i self = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + c + 1));
+        __m128i center = _mm_add_epi8(_mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + c + 1)), self),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + c + 1)));
+        __m128i right = _mm_add_epi8(_mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + c + 2)),
+                                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(mid + c + 2))),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(down + c + 2)));
+        __m128i count = _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(left, center), right), self);
+
+        // Zero the count of mine cells, then move it into the high nibble (count < 16, so the
+        // 16-bit shift never carries into the neighbouring byte)
+        count = _mm_andnot_si128(_mm_sub_epi8(zero, self), count);
+        __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + c));
+        bits = _mm_or_si128(_mm_and_si128(bits, low), _mm_slli_epi16(count, Cell::COUNT_SHIFT));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cells + c), bits);
+    }
+    countRowScalar(plane, out, r, c);
+}
+#endif
+
+#if defined(MINESWEEPER_AVX2_DISPATCH)
+// 32 cells per step, only called after checking the CPU supports AVX2
+__attribute__((target("avx2"))) void countRowAvx2(const MinePlane& plane, Cell* out, int r) {
+    const std::uint8_t* up = plane.row(r - 1);
+    const std::uint8_t* mid = plane.row(r);
+    const std::uint8_t* down = plane.row(r + 1);
+    std::uint8_t* cells = reinterpret_cast<std::uint8_t*>(out);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    int c = 0;
+    for (; c + 32 <= plane.columns; c += 32) {
+        __m256i left = _mm256_add_epi8(_mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + c)),
+                                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mid + c))),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + c)));
+        __m256i self = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mid + c + 1));
+        __m256i center = _mm256_add_epi8(_mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + c + 1)), self),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + c + 1)));
+        __m256i right = _mm256_add_epi8(_mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + c + 2)),
+                                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mid + c + 2))),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + c + 2)));
+        __m256i count = _mm256_sub_epi8(_mm256_add_epi8(_mm256_add_epi8(left, center), right), self);
+
+        count = _mm256_andnot_si256(_mm256_sub_epi8(zero, self), count);
+        __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + c));
+        bits = _mm256_or_si256(_mm256_and_si256(bits, low), _mm256_slli_epi16(count, Cell::COUNT_SHIFT));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(cells + c), bits);
+    }
+    countRowScalar(plane, out, r, c);
+}
+#endif
+
+typedef void (*CountRow)(const MinePlane&, Cell*, int);
+
+#if !(defined(__SSE2__) || defined(_M_X64))
+void countRowFallback(const MinePlane& plane, Cell* out, int r) {
+    countRowScalar(plane, out, r, 0);
+}
+#endif
+
+// Widest kernel the CPU supports, picked once
+CountRow selectKernel() {
+#if defined(MINESWEEPER_AVX2_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return countRowAvx2;
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    return countRowSse2;
+#else
+    return countRowFallback;
+#endif
+}
+
+// Copies the mine bits of rows [first, last) into the plane, zeroing the border around them
+void fillRows(MinePlane& plane, const Board& board, int first, int last) {
+    for (int r = first; r < last; ++r) {
+        const std::uint8_t* cells = reinterpret_cast<const std::uint8_t*>(board.data()) + static_cast<size_t>(r) * plane.columns;
+        std::uint8_t* row = plane.bytes.get() + static_cast<size_t>(r + 1) * plane.stride;
+        row[0] = 0;
+        int c = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i mine = _mm_set1_epi8(Cell::MINE);
+        for (; c + 16 <= plane.columns; c += 16) {
+            __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + c));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + c + 1), _mm_and_si128(bits, mine));
+        }
+#endif
+        for (; c < plane.columns; ++c) {
+            row[c + 1] = cells[c] & Cell::MINE;
+        }
+        std::memset(row + plane.columns + 1, 0, plane.stride - plane.columns - 1);
+    }
+}
+
+void countRows(const MinePlane& plane, Board& board, int first, int last, CountRow countRow) {
+    for (int r = first; r < last; ++r) {
+        countRow(plane, board.data() + static_cast<size_t>(r) * plane.columns, r);
+    }
+}
+
+} // namespace
+
+void calculateAdjacentMines(Board& board, unsigned threads) {
+    static const CountRow countRow = selectKernel();
+
+    MinePlane plane;
+    plane.columns = board.getColumns();
+    plane.rows = board.getRows();
+    plane.stride = plane.columns + 2 + 32; // Border on both sides plus slack for the widest vector load
+    plane.bytes.reset(new std::uint8_t[static_cast<size_t>(plane.rows + 2) * plane.stride]);
+    std::memset(plane.bytes.get(), 0, plane.stride); // Border rows above and below the board
+    std::memset(plane.bytes.get() + static_cast<size_t>(plane.rows + 1) * plane.stride, 0, plane.stride);
+
+    // Large boards are split into row bands, one per thread. Bands only read the plane rows
+    // next to them, so the plane is filled completely before any band starts counting.
+    if (threads == 0) {
+        threads = static_cast<size_t>(board.size()) >= PARALLEL_CELLS ? std::max(std::thread::hardware_concurrency(), 1u) : 1;
+    }
+    threads = std::min<unsigned>(threads, plane.rows);
+    if (threads <= 1) {
+        fillRows(plane, board, 0, plane.rows);
+        countRows(plane, board, 0, plane.rows, countRow);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    auto bandStart = [&](unsigned band) { return static_cast<int>(static_cast<long long>(plane.rows) * band / threads); };
+    for (unsigned band = 0; band < threads; ++band) {
+        workers.emplace_back(fillRows, std::ref(plane), std::cref(board), bandStart(band), bandStart(band + 1));
+    }
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+    for (unsigned band = 0; band < threads; ++band) {
+        workers.emplace_back(countRows, std::cref(plane), std::ref(board), bandStart(band), bandStart(band + 1), countRow);
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+void calculateAdjacentMinesScalar(Board& board) {
+    for (int row = 0; row < board.getRows(); ++row) {
+        for (int col = 0; col < board.getColumns(); ++col) {
+            if (board.at(row, col).isMine()) continue;
+
+            int mineCount = 0;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    int r = row + dr, c = col + dc;
+                    if (board.inBounds(r, c) && board.at(r, c).isMine()) {
+                        ++mineCount;
+                    }
+                }
+            }
+            board.at(row, col).setAdjacentMines(mineCount);
+        }
+    }
+}
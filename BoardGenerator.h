@@ -0,0 +1,24 @@
+#ifndef BOARD_GENERATOR_H
+#define BOARD_GENERATOR_H
+
+#include "Board.h"
+#include <cstdint>
+#include <vector>
+
+// Board generation steps used by GameEngine::reset, kept separate so they can be timed on their own
+
+// Places `mines` mines on a board that has none, replacing minePositions with their indices.
+// The layout depends only on (board size, mines, seed, excluded), and costs O(mines) at any density.
+// `excluded` is a sorted list of cells that must stay mine-free (e.g. around the first click).
+void placeMines(Board& board, int mines, std::uint64_t seed, std::vector<int>& minePositions,
+                const std::vector<int>& excluded = std::vector<int>());
+
+// Stores the number of adjacent mines in every non-mine cell. Vectorized (AVX2 or SSE2, picked at
+// run time, scalar elsewhere) and split into row bands across threads on large boards. `threads`
+// of 0 picks one thread for small boards and one per core for large ones.
+void calculateAdjacentMines(Board& board, unsigned threads = 0);
+
+// Straightforward bounds-checked version, the reference the fast kernel must match
+void calculateAdjacentMinesScalar(Board& board);
+
+#endif // BOARD_GENERATOR_H
@@ -0,0 +1,150 @@
+#include "BoardRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+BoardRenderer::BoardRenderer(const GameEngine& engine, float tileSize)
+    : engine(engine), tileSize(tileSize), background(sf::Quads), foreground(sf::Quads) {
+    // Vertices are created by the first draw, once the view is known
+}
+
+bool BoardRenderer::setAtlas(const TextureAtlas& atlas) {
+    const char* names[TILE_COUNT] = {"tile_hidden", "tile_revealed", "mine", "flag",
+                                     "number_1", "number_2", "number_3", "number_4",
+                                     "number_5", "number_6", "number_7", "number_8"};
+
+    for (int tile = 0; tile < TILE_COUNT; ++tile) {
+        tileRects[tile] = atlas.getRect(names[tile]);
+        if (tileRects[tile].width == 0) {
+            std::cerr << "Tile image missing from atlas: " << names[tile] << "\n";
+            return false;
+        }
+    }
+    texture = &atlas.getTexture();
+
+    rebuild();
+    return true;
+}
+
+void BoardRenderer::rebuild() {
+    const Board& board = engine.getBoard();
+    for (int row = visibleCells.firstRow; row < visibleCells.firstRow + visibleCells.rows; ++row) {
+        for (int col = visibleCells.firstCol; col < visibleCells.firstCol + visibleCells.columns; ++col) {
+            writeCell(board.index(row, col));
+        }
+    }
+}
+
+void BoardRenderer::update(const std::vector<int>& changedCells) {
+    for (int index : changedCells) {
+        writeCell(index);
+    }
+}
+
+void BoardRenderer::setDebugMode(bool enabled) {
+    if (debugMode == enabled) return;
+    debugMode = enabled;
+
+    // Debug mode only affects the mine cells
+    update(engine.getMinePositions());
+}
+
+BoardRenderer::CellRange BoardRenderer::rangeInView(const sf::RenderTarget& target, const sf::RenderStates& states) const {
+    // View area in board coordinates
+    const sf::View& view = target.getView();
+    sf::FloatRect area(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    area = states.transform.getInverse().transformRect(area);
+
+    // Every cell the area touches, clipped to the board
+    const Board& board = engine.getBoard();
+    int firstCol = std::max(0, static_cast<int>(std::floor(area.left / tileSize)));
+    int firstRow = std::max(0, static_cast<int>(std::floor(area.top / tileSize)));
+    int endCol = std::min(board.getColumns(), static_cast<int>(std::ceil((area.left + area.width) / tileSize)));
+    int endRow = std::min(board.getRows(), static_cast<int>(std::ceil((area.top + area.height) / tileSize)));
+
+    CellRange range;
+    if (endCol > firstCol && endRow > firstRow) {
+        range.firstRow = firstRow;
+        range.firstCol = firstCol;
+        range.rows = endRow - firstRow;
+        range.columns = endCol - firstCol;
+    }
+    return range;
+}
+
+void BoardRenderer::setRange(const CellRange& range) const {
+    visibleCells = range;
+    background.resize(static_cast<size_t>(range.rows) * range.columns * 4);
+    foreground.resize(static_cast<size_t>(range.rows) * range.columns * 4);
+
+    // Positions only change with the range, texture coordinates and colors with the cells
+    const Board& board = engine.getBoard();
+    int quad = 0;
+    for (int row = range.firstRow; row < range.firstRow + range.rows; ++row) {
+        for (int col = range.firstCol; col < range.firstCol + range.columns; ++col, ++quad) {
+            float x = col * tileSize;
+            float y = row * tileSize;
+            for (sf::VertexArray* layer : {&background, &foreground}) {
+                sf::Vertex* vertices = &(*layer)[quad * 4];
+                vertices[0].position = sf::Vector2f(x, y);
+                vertices[1].position = sf::Vector2f(x + tileSize, y);
+                vertices[2].position = sf::Vector2f(x + tileSize, y + tileSize);
+                vertices[3].position = sf::Vector2f(x, y + tileSize);
+            }
+            writeCell(board.index(row, col));
+        }
+    }
+}
+
+void BoardRenderer::writeCell(int index) const {
+    const Board& board = engine.getBoard();
+    int row = board.rowOf(index) - visibleCells.firstRow;
+    int col = board.colOf(index) - visibleCells.firstCol;
+    if (row < 0 || row >= visibleCells.rows || col < 0 || col >= visibleCells.columns) return;
+
+    int quad = row * visibleCells.columns + col;
+    Cell cell = board[index];
+
+    setQuad(background, quad, cell.isRevealed() ? TILE_REVEALED : TILE_HIDDEN, true);
+
+    if (cell.isRevealed()) {
+        if (cell.isMine()) {
+            setQuad(foreground, quad, TILE_MINE, true);
+        } else {
+            // Blank tile for empty revealed tiles
+            setQuad(foreground, quad, TILE_NUMBER_1 + cell.adjacentMines() - 1, cell.adjacentMines() > 0);
+        }
+    } else if (cell.isFlagged()) {
+        setQuad(foreground, quad, TILE_FLAG, true);
+    } else {
+        // If debug mode is active, reveal all mines
+        setQuad(foreground, quad, TILE_MINE, debugMode && cell.isMine());
+    }
+}
+
+void BoardRenderer::setQuad(sf::VertexArray& layer, int quad, int tile, bool visible) const {
+    sf::Vertex* vertices = &layer[quad * 4];
+    const sf::IntRect& rect = tileRects[tile];
+    float left = static_cast<float>(rect.left), top = static_cast<float>(rect.top);
+
+    // Invisible quads stay in the array with a transparent color so indices never shift
+    sf::Color color = visible ? sf::Color::White : sf::Color::Transparent;
+    vertices[0].texCoords = sf::Vector2f(left, top);
+    vertices[1].texCoords = sf::Vector2f(left + rect.width, top);
+    vertices[2].texCoords = sf::Vector2f(left + rect.width, top + rect.height);
+    vertices[3].texCoords = sf::Vector2f(left, top + rect.height);
+    for (int i = 0; i < 4; ++i) {
+        vertices[i].color = color;
+    }
+}
+
+void BoardRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    CellRange range = rangeInView(target, states);
+    if (range != visibleCells) {
+        setRange(range);
+    }
+
+    states.texture = texture;
+    target.draw(background, states);
+    target.draw(foreground, states);
+}
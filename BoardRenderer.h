@@ -0,0 +1,54 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include "GameEngine.h"
+#include "TextureAtlas.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Draws the board with one vertex array (quads) per layer:
+// the tile background and the foreground (number, mine or flag).
+// Only the cells inside the target's view have vertices, so memory follows
+// the window size rather than the board size. Between frames only the
+// vertices of changed cells are rewritten, all of them when the view moves.
+class BoardRenderer : public sf::Drawable {
+public:
+    BoardRenderer(const GameEngine& engine, float tileSize);
+
+    bool setAtlas(const TextureAtlas& atlas);      // Look up the tile images in the atlas
+    void rebuild();                                // Rewrite the vertices of every visible cell
+    void update(const std::vector<int>& changedCells); // Rewrite only the given cells
+    void setDebugMode(bool enabled);               // Show or hide the hidden mines
+
+private:
+    // Tile images looked up in the atlas
+    enum TileImage { TILE_HIDDEN, TILE_REVEALED, TILE_MINE, TILE_FLAG, TILE_NUMBER_1, TILE_COUNT = TILE_NUMBER_1 + 8 };
+
+    // Block of cells that have vertices, row by row
+    struct CellRange {
+        int firstRow = 0, firstCol = 0, rows = 0, columns = 0;
+        bool operator!=(const CellRange& other) const {
+            return firstRow != other.firstRow || firstCol != other.firstCol || rows != other.rows || columns != other.columns;
+        }
+    };
+
+    const GameEngine& engine;
+    float tileSize;
+    bool debugMode = false;
+
+    const sf::Texture* texture = nullptr;
+    sf::IntRect tileRects[TILE_COUNT];
+
+    // Vertex cache of the visible cells, drawing moves it along with the view
+    mutable CellRange visibleCells;
+    mutable sf::VertexArray background;
+    mutable sf::VertexArray foreground;
+
+    CellRange rangeInView(const sf::RenderTarget& target, const sf::RenderStates& states) const;
+    void setRange(const CellRange& range) const; // Lay out and fill the quads of a new visible range
+    void writeCell(int index) const;             // Cells outside the visible range are skipped
+    void setQuad(sf::VertexArray& layer, int quad, int tile, bool visible) const;
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
+
+#endif // BOARD_RENDERER_H
@@ -0,0 +1,140 @@
+#include "ChunkedBoard.h"
+#include "BitSet.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+const std::int64_t ChunkedBoard::COORDINATE_LIMIT;
+
+ChunkedBoard::ChunkedBoard(std::int64_t columns, std::int64_t rows, double density, std::uint64_t seed)
+    : columns(std::min(std::max<std::int64_t>(columns, 0), COORDINATE_LIMIT)),
+      rows(std::min(std::max<std::int64_t>(rows, 0), COORDINATE_LIMIT)),
+      density(std::min(std::max(density, 0.0), 1.0)), seed(seed) {
+    // Compare the top 53 bits of each draw against density * 2^53, exact for any double density
+    mineThreshold = static_cast<std::uint64_t>(std::ldexp(this->density, 53));
+}
+
+ChunkedBoard::Chunk& ChunkedBoard::chunkAt(std::int64_t row, std::int64_t col) {
+    std::int64_t chunkRow = chunkOf(row), chunkCol = chunkOf(col);
+    std::uint64_t key = keyOf(chunkRow, chunkCol);
+    if (lastChunk && key == lastKey) return *lastChunk;
+
+    std::unique_ptr<Chunk>& slot = chunks[key];
+    if (!slot) {
+        slot.reset(new Chunk());
+        generate(*slot, chunkRow, chunkCol);
+    }
+    lastKey = key;
+    lastChunk = slot.get();
+    return *slot;
+}
+
+ChunkedBoard::ChunkState& ChunkedBoard::stateOf(Chunk& chunk) {
+    if (!chunk.state) {
+        chunk.state.reset(new ChunkState()); // Value-initialized, nothing revealed or flagged
+        ++writtenChunks;
+    }
+    return *chunk.state;
+}
+
+void ChunkedBoard::generate(Chunk& chunk, std::int64_t chunkRow, std::int64_t chunkCol) const {
+    // Each chunk has its own generator, seeded from the board seed and its coordinates
+    Random random(Random::streamSeed(seed, keyOf(chunkRow, chunkCol)));
+    for (int r = 0; r < CHUNK_SIZE; ++r) {
+        std::uint64_t word = 0;
+        for (int c = 0; c < CHUNK_SIZE; ++c) {
+            if ((random.next() >> 11) < mineThreshold) word |= std::uint64_t(1) << c;
+        }
+        chunk.mines[r] = word;
+    }
+
+    // Cells outside a bounded board never hold mines (so they never count as neighbours),
+    // and neither does the area around the first click
+    for (int r = 0; r < CHUNK_SIZE; ++r) {
+        for (int c = 0; c < CHUNK_SIZE; ++c) {
+            std::int64_t row = chunkRow * CHUNK_SIZE + r, col = chunkCol * CHUNK_SIZE + c;
+            bool safe = !inBounds(row, col) ||
+                        (hasSafeArea && std::abs(row - safeRow) <= 1 && std::abs(col - safeCol) <= 1);
+            if (safe) chunk.mines[r] &= ~(std::uint64_t(1) << c);
+        }
+    }
+}
+
+bool ChunkedBoard::isMine(std::int64_t row, std::int64_t col) {
+    return (chunkAt(row, col).mines[offsetIn(row)] >> offsetIn(col)) & 1;
+}
+
+bool ChunkedBoard::isRevealed(std::int64_t row, std::int64_t col) {
+    const Chunk& chunk = chunkAt(row, col);
+    return chunk.state && ((chunk.state->revealed[offsetIn(row)] >> offsetIn(col)) & 1);
+}
+
+bool ChunkedBoard::isFlagged(std::int64_t row, std::int64_t col) {
+    const Chunk& chunk = chunkAt(row, col);
+    return chunk.state && ((chunk.state->flagged[offsetIn(row)] >> offsetIn(col)) & 1);
+}
+
+int ChunkedBoard::adjacentMines(std::int64_t row, std::int64_t col) {
+    int r = offsetIn(row), c = offsetIn(col);
+
+    // Inside a chunk: three row words, shifted so the 3x3 block lands in the low three bits
+    if (r > 0 && r < CHUNK_SIZE - 1 && c > 0 && c < CHUNK_SIZE - 1) {
+        const Chunk& chunk = chunkAt(row, col);
+        int count = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            count += popCount((chunk.mines[r + dr] >> (c - 1)) & 7);
+        }
+        return count - static_cast<int>((chunk.mines[r] >> c) & 1);
+    }
+
+    // On a chunk edge the neighbours span up to four chunks
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr || dc) && inBounds(row + dr, col + dc) && isMine(row + dr, col + dc)) ++count;
+        }
+    }
+    return count;
+}
+
+Cell ChunkedBoard::cellAt(std::int64_t row, std::int64_t col) {
+    Cell cell;
+    const Chunk& chunk = chunkAt(row, col);
+    int r = offsetIn(row), c = offsetIn(col);
+    if ((chunk.mines[r] >> c) & 1) cell.set(Cell::MINE);
+    if (chunk.state && ((chunk.state->revealed[r] >> c) & 1)) cell.set(Cell::REVEALED);
+    if (chunk.state && ((chunk.state->flagged[r] >> c) & 1)) cell.set(Cell::FLAGGED);
+    if (!cell.isMine()) cell.setAdjacentMines(adjacentMines(row, col));
+    return cell;
+}
+
+void ChunkedBoard::setRevealed(std::int64_t row, std::int64_t col) {
+    stateOf(chunkAt(row, col)).revealed[offsetIn(row)] |= std::uint64_t(1) << offsetIn(col);
+}
+
+void ChunkedBoard::toggleFlag(std::int64_t row, std::int64_t col) {
+    stateOf(chunkAt(row, col)).flagged[offsetIn(row)] ^= std::uint64_t(1) << offsetIn(col);
+}
+
+void ChunkedBoard::setSafeArea(std::int64_t row, std::int64_t col) {
+    hasSafeArea = true;
+    safeRow = row;
+    safeCol = col;
+
+    // Chunks generated before now get the area cleared too, later ones are generated without it
+    for (std::int64_t r = row - 1; r <= row + 1; ++r) {
+        for (std::int64_t c = col - 1; c <= col + 1; ++c) {
+            if (!inBounds(r, c)) continue;
+            auto found = chunks.find(keyOf(chunkOf(r), chunkOf(c)));
+            if (found != chunks.end()) {
+                found->second->mines[offsetIn(r)] &= ~(std::uint64_t(1) << offsetIn(c));
+            }
+        }
+    }
+}
+
+size_t ChunkedBoard::getMemoryUsage() const {
+    // Each map node holds the key, the pointer and the bucket chain link
+    return chunks.size() * (sizeof(Chunk) + sizeof(std::uint64_t) + sizeof(void*) * 2) + writtenChunks * sizeof(ChunkState);
+}
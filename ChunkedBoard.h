@@ -0,0 +1,91 @@
+#ifndef CHUNKED_BOARD_H
+#define CHUNKED_BOARD_H
+
+#include "Board.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+// Sparse board for huge or endless games. Cells live in 64x64 chunks that are only created
+// when something looks at them, so memory grows with the explored area, not the board area.
+// A chunk's mines follow from a hash of (seed, chunk coordinates): every cell is a mine with
+// probability `density`, the same on every run, without ever storing the untouched chunks.
+// Revealed and flagged bits are only allocated once a chunk is first written; the chunks that
+// are merely read (the neighbours of the explored area) hold their mines and nothing else.
+class ChunkedBoard {
+public:
+    static const int CHUNK_SIZE = 64; // One 64-bit word per chunk row
+    // Coordinates are limited to [-COORDINATE_LIMIT, COORDINATE_LIMIT), so both chunk coordinates
+    // fit in 32 bits and a chunk is keyed by one 64-bit word. Cells beyond are out of bounds.
+    static const std::int64_t COORDINATE_LIMIT = std::int64_t(CHUNK_SIZE) << 31;
+
+    // Columns and rows of 0 make that direction unbounded (negative coordinates included)
+    ChunkedBoard(std::int64_t columns, std::int64_t rows, double density, std::uint64_t seed);
+
+    std::int64_t getColumns() const { return columns; }
+    std::int64_t getRows() const { return rows; }
+    double getDensity() const { return density; }
+    std::uint64_t getSeed() const { return seed; }
+    bool inBounds(std::int64_t row, std::int64_t col) const {
+        return row >= -COORDINATE_LIMIT && row < COORDINATE_LIMIT && col >= -COORDINATE_LIMIT && col < COORDINATE_LIMIT &&
+               (columns == 0 || (col >= 0 && col < columns)) && (rows == 0 || (row >= 0 && row < rows));
+    }
+
+    // Cell queries take in-bounds cells and create the chunk if needed (its mines are fixed by
+    // the seed anyway); they do not allocate its revealed and flagged bits
+    bool isMine(std::int64_t row, std::int64_t col);
+    bool isRevealed(std::int64_t row, std::int64_t col);
+    bool isFlagged(std::int64_t row, std::int64_t col);
+    int adjacentMines(std::int64_t row, std::int64_t col);
+    Cell cellAt(std::int64_t row, std::int64_t col); // Packed like a dense Board cell, for views
+
+    void setRevealed(std::int64_t row, std::int64_t col);
+    void toggleFlag(std::int64_t row, std::int64_t col);
+
+    // Keeps the 3x3 area around a cell free of mines (the first click), also in existing chunks
+    void setSafeArea(std::int64_t row, std::int64_t col);
+
+    size_t getChunkCount() const { return chunks.size(); }
+    size_t getWrittenChunkCount() const { return writtenChunks; } // Chunks with revealed or flagged cells
+    size_t getMemoryUsage() const; // Bytes held by chunks
+
+private:
+    struct ChunkState {
+        std::uint64_t revealed[CHUNK_SIZE];
+        std::uint64_t flagged[CHUNK_SIZE];
+    };
+    struct Chunk {
+        std::uint64_t mines[CHUNK_SIZE];
+        std::unique_ptr<ChunkState> state; // Null until a cell of the chunk is revealed or flagged
+    };
+
+    std::int64_t columns;
+    std::int64_t rows;
+    double density;
+    std::uint64_t seed;
+    std::uint64_t mineThreshold; // A cell is a mine when its random draw is below this
+
+    bool hasSafeArea = false;
+    std::int64_t safeRow = 0;
+    std::int64_t safeCol = 0;
+
+    std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>> chunks;
+    size_t writtenChunks = 0;
+    std::uint64_t lastKey = 0;   // Most lookups hit the same chunk as the previous one
+    Chunk* lastChunk = nullptr;
+
+    static std::int64_t chunkOf(std::int64_t coordinate) { // Floor division, also for negatives
+        return coordinate >= 0 ? coordinate / CHUNK_SIZE : -((-coordinate + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    }
+    static int offsetIn(std::int64_t coordinate) { return static_cast<int>(coordinate - chunkOf(coordinate) * CHUNK_SIZE); }
+    static std::uint64_t keyOf(std::int64_t chunkRow, std::int64_t chunkCol) { // Exact within COORDINATE_LIMIT
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkRow)) << 32) |
+               static_cast<std::uint32_t>(chunkCol);
+    }
+
+    Chunk& chunkAt(std::int64_t row, std::int64_t col);
+    ChunkState& stateOf(Chunk& chunk); // Allocates the revealed and flagged bits on first write
+    void generate(Chunk& chunk, std::int64_t chunkRow, std::int64_t chunkCol) const;
+};
+
+#endif // CHUNKED_BOARD_H
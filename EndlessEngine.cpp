@@ -0,0 +1,84 @@
+#include "EndlessEngine.h"
+#include "Logger.h"
+
+EndlessEngine::EndlessEngine(double density, std::uint64_t seed, std::int64_t columns, std::int64_t rows)
+    : board(columns, rows, density, seed) {}
+
+bool EndlessEngine::reveal(std::int64_t row, std::int64_t col) {
+    changedCells.clear();
+    if (state != State::Playing || !board.inBounds(row, col)) return false;
+
+    if (!started) {
+        board.setSafeArea(row, col);
+        started = true;
+    }
+    if (board.isFlagged(row, col) || board.isRevealed(row, col)) return false;
+
+    board.setRevealed(row, col);
+    changedCells.push_back(Position{row, col});
+
+    if (board.isMine(row, col)) {
+        state = State::Lost;
+        LOG_DEBUG("Mine revealed at (%lld, %lld), endless game lost with %llu cells revealed",
+                  static_cast<long long>(row), static_cast<long long>(col),
+                  static_cast<unsigned long long>(revealedCount));
+        return true;
+    }
+
+    ++revealedCount;
+    if (board.adjacentMines(row, col) == 0) {
+        floodStack.push_back(Position{row, col});
+        flood();
+    }
+    return true;
+}
+
+bool EndlessEngine::continueOpening() {
+    changedCells.clear();
+    if (state != State::Playing || floodStack.empty()) return false;
+    flood();
+    return true;
+}
+
+bool EndlessEngine::toggleFlag(std::int64_t row, std::int64_t col) {
+    changedCells.clear();
+    if (state != State::Playing || !board.inBounds(row, col) || board.isRevealed(row, col)) return false;
+
+    board.toggleFlag(row, col);
+    if (board.isFlagged(row, col)) {
+        ++flagCount;
+    } else {
+        --flagCount;
+    }
+    changedCells.push_back(Position{row, col});
+    return true;
+}
+
+void EndlessEngine::flood() {
+    // Same iterative fill as GameEngine::revealOpening, but it stops after floodLimit cells and
+    // keeps the stack, so a huge opening is revealed over several calls
+    size_t revealed = 0;
+    while (!floodStack.empty() && revealed < floodLimit) {
+        Position current = floodStack.back();
+        floodStack.pop_back();
+
+        for (std::int64_t r = current.row - 1; r <= current.row + 1; ++r) {
+            for (std::int64_t c = current.col - 1; c <= current.col + 1; ++c) {
+                if (!board.inBounds(r, c) || board.isRevealed(r, c) || board.isFlagged(r, c)) continue;
+
+                // Neighbors of a zero cell are never mines
+                board.setRevealed(r, c);
+                changedCells.push_back(Position{r, c});
+                ++revealedCount;
+                ++revealed;
+
+                if (board.adjacentMines(r, c) == 0) {
+                    floodStack.push_back(Position{r, c});
+                }
+            }
+        }
+    }
+    if (!floodStack.empty()) {
+        LOG_DEBUG("Opening capped at %zu cells, %zu cells left to continue from", revealed, floodStack.size());
+    }
+}
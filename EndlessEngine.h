@@ -0,0 +1,54 @@
+#ifndef ENDLESS_ENGINE_H
+#define ENDLESS_ENGINE_H
+
+#include "ChunkedBoard.h"
+#include <cstdint>
+#include <vector>
+
+// Game rules on a ChunkedBoard, for endless mode and boards too large to store densely.
+// There is no winning an endless board; the score is the number of safe cells revealed.
+// On a sparse board an opening can be arbitrarily large, so a reveal stops after a fixed
+// number of cells and the rest of the opening is continued by later calls.
+class EndlessEngine {
+public:
+    enum class State { Playing, Lost };
+
+    struct Position {
+        std::int64_t row;
+        std::int64_t col;
+    };
+
+    // Columns and rows of 0 make the board unbounded in that direction
+    EndlessEngine(double density, std::uint64_t seed, std::int64_t columns = 0, std::int64_t rows = 0);
+
+    bool reveal(std::int64_t row, std::int64_t col);     // Returns true if the board changed
+    bool toggleFlag(std::int64_t row, std::int64_t col);
+    bool continueOpening();                              // Reveal up to the limit more cells of a capped opening
+    bool hasPendingOpening() const { return !floodStack.empty(); }
+
+    void setFloodLimit(size_t cells) { floodLimit = cells; } // Cells revealed per call at most
+    size_t getFloodLimit() const { return floodLimit; }
+
+    const std::vector<Position>& getChangedCells() const { return changedCells; }
+
+    ChunkedBoard& getBoard() { return board; }
+    State getState() const { return state; }
+    bool isLost() const { return state == State::Lost; }
+    std::uint64_t getRevealedCount() const { return revealedCount; } // The score
+    std::uint64_t getFlagCount() const { return flagCount; }
+
+private:
+    ChunkedBoard board;
+    State state = State::Playing;
+    bool started = false; // The first reveal sets the safe area
+    std::uint64_t revealedCount = 0;
+    std::uint64_t flagCount = 0;
+    size_t floodLimit = 100000;
+
+    std::vector<Position> changedCells;
+    std::vector<Position> floodStack; // Zero cells whose neighbours are still to be revealed
+
+    void flood();
+};
+
+#endif // ENDLESS_ENGINE_H
@@ -0,0 +1,63 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <cstdint>
+#include <vector>
+
+// Counts per non-negative integer key (here: seconds) with O(log n) updates, prefix sums and
+// k-th element search. The size is a power of two and doubles as larger keys show up; with
+// that size the new upper half starts empty except for its top node, which covers everything.
+class FenwickTree {
+public:
+    void add(int key, std::int64_t delta) {
+        if (key >= size()) grow(key + 1);
+        for (int i = key + 1; i <= size(); i += i & -i) {
+            tree[i] += delta;
+        }
+        total += delta;
+    }
+
+    // Sum of the counts of keys [0, key]
+    std::uint64_t prefix(int key) const {
+        if (key < 0) return 0;
+        if (key >= size()) return total;
+        std::int64_t sum = 0;
+        for (int i = key + 1; i > 0; i -= i & -i) {
+            sum += tree[i];
+        }
+        return sum;
+    }
+
+    std::uint64_t get(int key) const { return prefix(key) - prefix(key - 1); }
+    std::uint64_t getTotal() const { return total; }
+    int size() const { return static_cast<int>(tree.size()) - 1; }
+
+    // Smallest key whose prefix sum reaches k (1-based), or size() if there are fewer than k
+    int findKth(std::uint64_t k) const {
+        if (k == 0 || k > getTotal()) return size();
+        int position = 0;
+        for (int step = size(); step > 0; step >>= 1) {
+            if (position + step <= size() && static_cast<std::uint64_t>(tree[position + step]) < k) {
+                position += step;
+                k -= tree[position];
+            }
+        }
+        return position; // Keys are stored one-based
+    }
+
+private:
+    std::vector<std::int64_t> tree = std::vector<std::int64_t>(1, 0); // tree[0] unused
+    std::int64_t total = 0;
+
+    void grow(int needed) {
+        if (size() == 0) tree.assign(2, 0); // Nothing stored yet
+        int newSize = size();
+        while (newSize < needed) {
+            newSize *= 2;
+            tree.resize(newSize + 1, 0);
+            tree[newSize] = total; // Covers (0, newSize], everything stored so far
+        }
+    }
+};
+
+#endif // FENWICK_TREE_H
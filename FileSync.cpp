@@ -0,0 +1,39 @@
+#include "FileSync.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool replaceFile(const std::string& temporary, const std::string& file) {
+#ifdef _WIN32
+    // rename() does not replace an existing file here, and removing the old one first would leave
+    // neither if the game died in between. MoveFileEx replaces it in one step and, with write
+    // through, returns once the move is on the disk.
+    return MoveFileExA(temporary.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(temporary.c_str(), file.c_str()) != 0) return false;
+
+    // The rename is an entry in the directory, which has to reach the disk as well
+    std::string::size_type slash = file.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : file.substr(0, slash);
+    int descriptor = open(directory.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    bool synced = fsync(descriptor) == 0;
+    close(descriptor);
+    return synced;
+#endif
+}
@@ -0,0 +1,17 @@
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <cstdio>
+#include <string>
+
+// Helpers for files that have to survive a power loss or OS crash, not just a crash of the
+// game. fflush only hands data to the OS; these also wait until it is on the disk.
+
+// Flushes the stream and forces its data to the disk
+bool syncFile(std::FILE* file);
+
+// Renames a fully written and synced temporary file over `file`, then syncs the directory so
+// the rename itself is on disk. Afterwards the old or the new contents are there, never neither.
+bool replaceFile(const std::string& temporary, const std::string& file);
+
+#endif // FILE_SYNC_H
@@ -0,0 +1,328 @@
+#include "GameEngine.h"
+#include "BoardGenerator.h"
+#include "Logger.h"
+#include "NoGuessGenerator.h"
+#include "Random.h"
+#include <algorithm>
+
+GameEngine::GameEngine(int columns, int rows, int mines, std::uint64_t seed, Generation generation)
+    : board(columns, rows), seed(seed), generation(generation), changedMark(columns * rows) {
+    // The safe modes need at least one cell without a mine for the first click
+    int maxMines = generation == Generation::Random ? columns * rows : columns * rows - 1;
+    this->mines = std::min(std::max(mines, 0), std::max(maxMines, 0));
+    reset(seed);
+}
+
+void GameEngine::reset() {
+    // Derive the next seed deterministically, so a sequence of games can be replayed from the first seed
+    std::uint64_t next = seed;
+    reset(Random::splitMix(next));
+}
+
+void GameEngine::reset(std::uint64_t newSeed) {
+    seed = newSeed;
+
+    // Clear every cell back to its hidden state
+    board.clear();
+    state = State::Playing;
+    flagCount = 0;
+    correctFlagCount = 0;
+    revealedSafeCount = 0;
+    changedCells.clear();
+
+    // Place mines now, or on the first reveal when it has to be safe
+    minePositions.clear();
+    generated = false;
+    if (generation == Generation::Random) {
+        generate(-1);
+    }
+    LOG_DEBUG("Board reset: %dx%d with %d mines, seed %llu", board.getColumns(), board.getRows(), mines,
+              static_cast<unsigned long long>(seed));
+}
+
+bool GameEngine::restore(const SavedState& saved) {
+    if (!isConsistent(saved)) return false;
+
+    // Plain copies, the saved arrays already have the in-memory layout
+    std::copy(saved.cells, saved.cells + board.size(), board.data());
+    minePositions.assign(saved.minePositions, saved.minePositions + saved.minePositionCount);
+    seed = saved.seed;
+    state = saved.state;
+    generated = saved.generated;
+    flagCount = saved.flagCount;
+    correctFlagCount = saved.correctFlagCount;
+    revealedSafeCount = saved.revealedSafeCount;
+    changedCells.clear();
+    LOG_DEBUG("Board restored: %dx%d with %d mines, %d cells revealed", board.getColumns(), board.getRows(), mines,
+              revealedSafeCount);
+    return true;
+}
+
+bool GameEngine::isConsistent(const SavedState& saved) const {
+    if (saved.state != State::Playing && saved.state != State::Won && saved.state != State::Lost) return false;
+    if (saved.minePositionCount != (saved.generated ? mines : 0) || saved.flagCount < 0 ||
+        saved.revealedSafeCount < 0 || saved.revealedSafeCount > getSafeCellCount()) {
+        return false;
+    }
+
+    // Every mine listed once, and the count each one adds to its neighbours
+    std::vector<std::uint8_t> expected(board.size(), 0);
+    const std::uint8_t LISTED = 0x80;
+    for (int i = 0; i < saved.minePositionCount; ++i) {
+        int index = saved.minePositions[i];
+        if (index < 0 || index >= board.size() || (expected[index] & LISTED)) return false;
+        expected[index] |= LISTED;
+        int row = board.rowOf(index), col = board.colOf(index);
+        for (int r = row - 1; r <= row + 1; ++r) {
+            for (int c = col - 1; c <= col + 1; ++c) {
+                if (board.inBounds(r, c)) ++expected[board.index(r, c)];
+            }
+        }
+    }
+
+    // Each cell has to agree with the mine list, and the cells with the counters, or the game
+    // could never be won or lost properly
+    int flags = 0, correctFlags = 0, revealedSafe = 0, revealedMines = 0;
+    for (int i = 0; i < board.size(); ++i) {
+        const Cell& cell = saved.cells[i];
+        bool listed = (expected[i] & LISTED) != 0;
+        int count = listed ? 0 : expected[i];
+        if ((cell.bits & 0x08) || cell.isMine() != listed || cell.adjacentMines() != count) return false;
+        if (cell.isFlagged() && cell.isRevealed() && saved.state != State::Lost) return false;
+
+        if (cell.isFlagged()) {
+            ++flags;
+            if (cell.isMine()) ++correctFlags;
+        }
+        if (cell.isRevealed()) {
+            if (cell.isMine()) ++revealedMines;
+            else ++revealedSafe;
+        }
+    }
+    if (flags != saved.flagCount || correctFlags != saved.correctFlagCount || revealedSafe != saved.revealedSafeCount) {
+        return false;
+    }
+
+    // The state has to follow from the cells: a lost game shows every mine, a won one every safe cell
+    switch (saved.state) {
+        case State::Playing:
+            return revealedMines == 0 && revealedSafe < getSafeCellCount();
+        case State::Won:
+            return revealedMines == 0 && revealedSafe == getSafeCellCount();
+        case State::Lost:
+            return revealedMines == saved.minePositionCount && revealedMines > 0;
+    }
+    return false;
+}
+
+void GameEngine::generate(int firstClick) {
+    std::vector<int> excluded;
+    if (firstClick >= 0) {
+        int row = board.rowOf(firstClick), col = board.colOf(firstClick);
+
+        if (generation == Generation::NoGuess) {
+            std::uint64_t candidate;
+            if (findNoGuessSeed(board.getColumns(), board.getRows(), mines, row, col, seed, candidate,
+                                NO_GUESS_CANDIDATES, generatorThreads)) {
+                seed = candidate;
+            } else {
+                LOG_WARN("No board solvable without guessing found for seed %llu, a guess may be needed",
+                         static_cast<unsigned long long>(seed));
+            }
+        }
+
+        // Keep the 3x3 area clear so the first click opens up, or only the clicked cell on very dense boards
+        for (int r = std::max(row - 1, 0); r <= std::min(row + 1, board.getRows() - 1); ++r) {
+            for (int c = std::max(col - 1, 0); c <= std::min(col + 1, board.getColumns() - 1); ++c) {
+                excluded.push_back(board.index(r, c));
+            }
+        }
+        if (board.size() - static_cast<int>(excluded.size()) < mines) {
+            excluded.assign(1, firstClick);
+        }
+    }
+
+    // Place mines and calculate adjacent mine counts
+    placeMines(board, mines, seed, minePositions, excluded);
+    calculateAdjacentMines(board);
+    generated = true;
+
+    // Flags placed before the first reveal were counted against an empty board
+    correctFlagCount = 0;
+    for (int index : minePositions) {
+        if (board[index].isFlagged()) ++correctFlagCount;
+    }
+}
+
+bool GameEngine::reveal(int row, int col) {
+    Action action = {ActionType::Reveal, row, col};
+    return apply(&action, 1);
+}
+
+bool GameEngine::toggleFlag(int row, int col) {
+    Action action = {ActionType::Flag, row, col};
+    return apply(&action, 1);
+}
+
+bool GameEngine::chord(int row, int col) {
+    Action action = {ActionType::Chord, row, col};
+    return apply(&action, 1);
+}
+
+bool GameEngine::apply(const Action* actions, size_t count) {
+    changedCells.clear();
+    if (state != State::Playing) return false;
+
+    // Apply every action first, then decide the game state once. Actions after one that
+    // hits a mine are ignored, as they would be after the game ends.
+    mineHit = false;
+    for (size_t i = 0; i < count && !mineHit; ++i) {
+        const Action& action = actions[i];
+        if (!board.inBounds(action.row, action.col)) continue;
+
+        int index = board.index(action.row, action.col);
+        switch (action.type) {
+            case ActionType::Reveal:
+                revealCell(index);
+                break;
+            case ActionType::Flag:
+                flagCell(index);
+                break;
+            case ActionType::Chord:
+                chordCell(index);
+                break;
+        }
+    }
+
+    if (mineHit) {
+        revealAllMines();
+        state = State::Lost;
+    } else if (revealedSafeCount == getSafeCellCount()) {
+        // The player wins once every non-mine cell is revealed
+        state = State::Won;
+        LOG_DEBUG("All safe cells revealed, game won");
+    }
+    // Each changed cell was listed once however many actions touched it, clear the marks for the next batch
+    for (int index : changedCells) {
+        changedMark.reset(index);
+    }
+    LOG_TRACE("Applied %zu actions, %zu cells changed", count, changedCells.size());
+    return !changedCells.empty();
+}
+
+void GameEngine::markChanged(int index) {
+    if (changedMark.test(index)) return;
+    changedMark.set(index);
+    changedCells.push_back(index);
+}
+
+void GameEngine::revealCell(int index) {
+    if (!generated && !board[index].isFlagged()) {
+        generate(index);
+    }
+
+    Cell& cell = board[index];
+    if (cell.isFlagged() || cell.isRevealed()) return;
+
+    cell.set(Cell::REVEALED);
+    markChanged(index);
+
+    if (cell.isMine()) {
+        mineHit = true;
+        LOG_DEBUG("Mine revealed at (%d, %d), game lost", board.rowOf(index), board.colOf(index));
+        return;
+    }
+
+    ++revealedSafeCount;
+    if (cell.adjacentMines() == 0) {
+        revealOpening(index);
+    }
+}
+
+void GameEngine::flagCell(int index) {
+    Cell& cell = board[index];
+    if (cell.isRevealed()) return;
+
+    cell.toggle(Cell::FLAGGED);
+    int delta = cell.isFlagged() ? 1 : -1;
+    flagCount += delta;
+    if (cell.isMine()) correctFlagCount += delta;
+    markChanged(index);
+}
+
+void GameEngine::chordCell(int index) {
+    // Chording a revealed number whose flags already account for all of its mines
+    // reveals every other hidden neighbour at once
+    Cell cell = board[index];
+    if (!cell.isRevealed() || cell.isMine() || cell.adjacentMines() == 0) return;
+
+    const int columns = board.getColumns();
+    const int row = index / columns, col = index % columns;
+    int firstRow = std::max(row - 1, 0), lastRow = std::min(row + 1, board.getRows() - 1);
+    int firstCol = std::max(col - 1, 0), lastCol = std::min(col + 1, columns - 1);
+
+    int flags = 0;
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            if (board[r * columns + c].isFlagged()) ++flags;
+        }
+    }
+    if (flags != cell.adjacentMines()) return;
+
+    for (int r = firstRow; r <= lastRow; ++r) {
+        for (int c = firstCol; c <= lastCol; ++c) {
+            revealCell(r * columns + c); // Skips flagged and revealed cells
+        }
+    }
+}
+
+void GameEngine::revealOpening(int index) {
+    // Iterative flood fill from an already revealed zero cell. A zero cell is pushed exactly
+    // once, at the moment it gets revealed, so the cost is linear in the size of the opening
+    // and the call stack stays flat no matter how large the opening is.
+    const int columns = board.getColumns();
+    const int rows = board.getRows();
+
+    floodStack.clear();
+    floodStack.push_back(index);
+
+    while (!floodStack.empty()) {
+        int current = floodStack.back();
+        floodStack.pop_back();
+
+        int row = current / columns;
+        int col = current % columns;
+        int firstRow = std::max(row - 1, 0), lastRow = std::min(row + 1, rows - 1);
+        int firstCol = std::max(col - 1, 0), lastCol = std::min(col + 1, columns - 1);
+
+        for (int r = firstRow; r <= lastRow; ++r) {
+            for (int c = firstCol; c <= lastCol; ++c) {
+                int neighborIndex = r * columns + c;
+                Cell& neighbor = board[neighborIndex];
+
+                // Skip already revealed or flagged cells (this also skips the current cell)
+                if (neighbor.bits & (Cell::REVEALED | Cell::FLAGGED)) continue;
+
+                // Neighbors of a zero cell are never mines
+                neighbor.set(Cell::REVEALED);
+                markChanged(neighborIndex);
+                ++revealedSafeCount;
+
+                if (neighbor.adjacentMines() == 0) {
+                    floodStack.push_back(neighborIndex);
+                }
+            }
+        }
+    }
+}
+
+void GameEngine::revealAllMines() {
+    // Only the mine list is visited, not the whole board
+    for (int index : minePositions) {
+        Cell& cell = board[index];
+        if (!cell.isRevealed()) {
+            cell.set(Cell::REVEALED);
+            markChanged(index);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+
+#include "BitSet.h"
+#include "Board.h"
+#include <cstdint>
+#include <vector>
+
+// Headless Minesweeper rules (mine placement, reveal, flag, win/loss).
+// Has no SFML dependency so it can be driven by benchmarks, solvers or servers.
+class GameEngine {
+public:
+    enum class State { Playing, Won, Lost };
+
+    // One player action. Flag toggles, Chord reveals the hidden neighbours of a revealed
+    // number once its flags account for all of its mines.
+    enum class ActionType { Reveal, Flag, Chord };
+    struct Action {
+        ActionType type;
+        int row;
+        int col;
+    };
+
+    // How mines are placed. The safe modes wait for the first reveal and keep the 3x3 area
+    // around it mine-free, NoGuess also makes sure the board can be solved without guessing.
+    enum class Generation { Random, SafeFirstClick, NoGuess };
+
+    // The mine layout depends only on (columns, rows, mines, seed), plus the first click in the safe modes
+    GameEngine(int columns, int rows, int mines, std::uint64_t seed, Generation generation = Generation::Random);
+
+    // Threads a NoGuess board search may use, 0 (the default) for all cores. Callers that already
+    // run one game per core set 1, so the search stays on their thread. The board is the same either way.
+    void setGeneratorThreads(unsigned threads) { generatorThreads = threads; }
+
+    void reset();                       // New board, seeded with the next seed derived from the current one
+    void reset(std::uint64_t seed);     // New board from an explicit seed
+    bool reveal(int row, int col);      // Left click, returns true if the board changed
+    bool toggleFlag(int row, int col);  // Right click, returns true if the board changed
+    bool chord(int row, int col);       // Click on a satisfied number, returns true if the board changed
+
+    // Applies a batch of actions in one pass and evaluates win/loss once at the end.
+    // Returns true if the board changed; getChangedCells() then lists every changed cell once.
+    bool apply(const Action* actions, size_t count);
+    bool apply(const std::vector<Action>& actions) { return apply(actions.data(), actions.size()); }
+
+    // Everything needed to continue a saved game (see Snapshot.h). The arrays are only read
+    // during restore(), which copies them.
+    struct SavedState {
+        std::uint64_t seed;
+        State state;
+        bool generated;
+        const Cell* cells;          // columns * rows cells
+        const std::int32_t* minePositions;
+        int minePositionCount;      // Zero while a safe-mode board waits for its first reveal
+        int flagCount;
+        int correctFlagCount;
+        int revealedSafeCount;
+    };
+    // Continues a saved game of the same size and mine count. False (and unchanged) if it does not
+    // fit, or if its cells disagree with its mine list or counters (a damaged save).
+    bool restore(const SavedState& saved);
+
+    // Indices of the cells changed by the last action or batch, so views can update only those
+    const std::vector<int>& getChangedCells() const { return changedCells; }
+
+    // Board queries
+    int getColumns() const { return board.getColumns(); }
+    int getRows() const { return board.getRows(); }
+    int getMines() const { return mines; }
+    std::uint64_t getSeed() const { return seed; } // For NoGuess, the seed of the accepted candidate board
+    Generation getGeneration() const { return generation; }
+    bool isGenerated() const { return generated; } // False until the first reveal in the safe modes
+    bool inBounds(int row, int col) const { return board.inBounds(row, col); }
+    Cell cellAt(int row, int col) const { return board.at(row, col); }
+    const Board& getBoard() const { return board; }
+
+    // Game state queries
+    State getState() const { return state; }
+    bool isWon() const { return state == State::Won; }
+    bool isLost() const { return state == State::Lost; }
+    bool isOver() const { return state != State::Playing; }
+    int getFlagCount() const { return flagCount; }
+    int getCorrectFlagCount() const { return correctFlagCount; } // Flags placed on mines
+    int getRevealedSafeCount() const { return revealedSafeCount; }
+    int getSafeCellCount() const { return board.size() - mines; }
+    int getRemainingMines() const { return mines - flagCount; } // Value shown by the mine counter
+    const std::vector<int>& getMinePositions() const { return minePositions; }
+
+private:
+    Board board;
+    int mines;
+    std::uint64_t seed;
+    Generation generation;
+    bool generated = false;
+    unsigned generatorThreads = 0;
+    State state = State::Playing;
+
+    // Running counters, kept up to date as cells change so no query has to scan the board
+    int flagCount = 0;
+    int correctFlagCount = 0;
+    int revealedSafeCount = 0;
+    std::vector<int> minePositions;
+
+    std::vector<int> changedCells;
+    BitSet changedMark;          // Cells already in changedCells during the current batch
+    bool mineHit = false;        // Set during a batch, the state is decided once it ends
+    std::vector<int> floodStack; // Reused between reveals to avoid reallocating
+
+    void generate(int firstClick); // Place mines, keeping the area around firstClick (if >= 0) clear
+    bool isConsistent(const SavedState& saved) const;
+    void markChanged(int index);
+    void revealCell(int index);
+    void flagCell(int index);
+    void chordCell(int index);
+    void revealOpening(int index);
+    void revealAllMines();
+};
+
+#endif // GAME_ENGINE_H
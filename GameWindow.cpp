@@ -1,63 +1,72 @@
 #include "GameWindow.h"
+#include "Logger.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
-#include <ctime>
 #include <iostream>
 #include <vector>
 
-sf::Texture numberTextures[8]; // Array to hold textures for numbers 1 to 8
-
 const float TILE_SIZE = 32.0f;
 const float BUTTON_SIZE = 32.0f;
+const std::chrono::seconds AUTOSAVE_INTERVAL(10); // Longest stretch of play an autosave can lose
 
 
 
 
-GameWindow::GameWindow(int columns, int rows, int mines, const std::string& fontPath, const std::string& imagePath, const std::string& playerName)
-    : window(sf::VideoMode(columns * TILE_SIZE, (rows * TILE_SIZE) + 100), "Minesweeper"),
-      columns(columns), rows(rows), mines(mines), currentCounter(mines), playerName(playerName),
-      leaderboard("files/font.ttf", "files/leaderboard.txt") { // Initialize leaderboard
+GameWindow::GameWindow(int columns, int rows, int mines, const std::string& fontPath, const std::string& imagePath, const std::string& playerName,
+                       GameEngine::Generation generation)
+    : leaderboard("files/font.ttf", "files/scores.log", columns, rows, mines), // Initialize leaderboard
+      window(sf::VideoMode(columns * TILE_SIZE, (rows * TILE_SIZE) + 100), "Minesweeper"), playerName(playerName),
+      engine(columns, rows, mines, Random::entropySeed(), generation), boardRenderer(engine, TILE_SIZE), columns(columns), rows(rows), mines(mines) {
     // Load font
     if (!font.loadFromFile(fontPath)) {
         std::cerr << "Failed to load font\n";
         exit(EXIT_FAILURE);
     }
 
-    // Load textures
-    if (!hiddenTexture.loadFromFile(imagePath + "/tile_hidden.png") ||
-        !revealedTexture.loadFromFile(imagePath + "/tile_revealed.png") ||
-        !mineTexture.loadFromFile(imagePath + "/mine.png") ||
-        !flagTexture.loadFromFile(imagePath + "/flag.png") ||
-        !digitsTexture.loadFromFile(imagePath + "/digits.png")) {
-        std::cerr << "Failed to load base textures\n";
-        exit(EXIT_FAILURE);
+    // Scores from before the score log existed are carried over once
+    if (leaderboard.isEmpty()) {
+        leaderboard.importFile("files/leaderboard.txt");
     }
-
-
-    // Load number textures
-    for (int i = 0; i < 8; ++i) {
-        if (!numberTextures[i].loadFromFile(imagePath + "/number_" + std::to_string(i + 1) + ".png")) {
-            std::cerr << "Failed to load texture for number " << (i + 1) << "\n";
+    // The overlay sits centered over the board, or at its top left corner when the board is smaller
+    leaderboard.setPosition(std::max(0.0f, (columns * TILE_SIZE - Leaderboard::WIDTH) / 2.0f),
+                            std::max(0.0f, (rows * TILE_SIZE - Leaderboard::HEIGHT) / 2.0f));
+
+    // Pack every image into the texture atlas
+    const char* imageNames[] = {"tile_hidden", "tile_revealed", "mine", "flag",
+                                "number_1", "number_2", "number_3", "number_4",
+                                "number_5", "number_6", "number_7", "number_8", "digits",
+                                "face_happy", "face_win", "face_lose", "debug", "pause", "play", "leaderboard"};
+    for (const char* name : imageNames) {
+        if (!atlas.addImage(name, imagePath + "/" + name + ".png")) {
             exit(EXIT_FAILURE);
         }
     }
-
-    // Load button textures
-    if (!happyFaceTexture.loadFromFile(imagePath + "/face_happy.png") ||
-        !winFaceTexture.loadFromFile(imagePath + "/face_win.png") ||
-        !loseFaceTexture.loadFromFile(imagePath + "/face_lose.png") ||
-        !debugTexture.loadFromFile(imagePath + "/debug.png") ||
-        !pauseTexture.loadFromFile(imagePath + "/pause.png") ||
-        !playTexture.loadFromFile(imagePath + "/play.png") ||
-        !leaderboardTexture.loadFromFile(imagePath + "/leaderboard.png")) {
-        std::cerr << "Failed to load button textures\n";
+    if (!atlas.build() || !boardRenderer.setAtlas(atlas)) {
+        std::cerr << "Failed to load textures\n";
         exit(EXIT_FAILURE);
     }
 
+    // Look up the button and digit images
+    happyFaceRect = atlas.getRect("face_happy");
+    winFaceRect = atlas.getRect("face_win");
+    loseFaceRect = atlas.getRect("face_lose");
+    debugRect = atlas.getRect("debug");
+    pauseRect = atlas.getRect("pause");
+    playRect = atlas.getRect("play");
+    leaderboardRect = atlas.getRect("leaderboard");
+    digitsRect = atlas.getRect("digits");
+
     // Initialize button sprites
-    happyFace.setTexture(happyFaceTexture);
-    debugButton.setTexture(debugTexture);
-    pauseButton.setTexture(pauseTexture);
-    leaderboardButton.setTexture(leaderboardTexture);
+    happyFace.setTexture(atlas.getTexture());
+    happyFace.setTextureRect(happyFaceRect);
+    debugButton.setTexture(atlas.getTexture());
+    debugButton.setTextureRect(debugRect);
+    pauseButton.setTexture(atlas.getTexture());
+    pauseButton.setTextureRect(pauseRect);
+    leaderboardButton.setTexture(atlas.getTexture());
+    leaderboardButton.setTextureRect(leaderboardRect);
 
     // Set button positions
     happyFace.setPosition((columns * 32) / 2.0 - 32, 32 * (rows + 0.5));
@@ -65,263 +74,134 @@ GameWindow::GameWindow(int columns, int rows, int mines, const std::string& font
     pauseButton.setPosition((columns * 32) - 240, 32 * (rows + 0.5));
     leaderboardButton.setPosition((columns * 32) - 176, 32 * (rows + 0.5));
 
+    // Hint button, between the mine counter and the face
+    hintButton.setSize(sf::Vector2f(BUTTON_SIZE * 2 - 2, BUTTON_SIZE * 2 - 2));
+    hintButton.setPosition(113, 32 * (rows + 0.5) + 1);
+    hintButton.setFillColor(sf::Color(192, 192, 192));
+    hintButton.setOutlineColor(sf::Color(128, 128, 128));
+    hintButton.setOutlineThickness(1);
+    hintLabel.setFont(font);
+    hintLabel.setCharacterSize(18);
+    hintLabel.setFillColor(sf::Color::Black);
+    hintLabel.setString("Hint");
+    hintLabel.setPosition(hintButton.getPosition().x + (hintButton.getSize().x - hintLabel.getLocalBounds().width) / 2,
+                          hintButton.getPosition().y + 20);
+
+    // Outline drawn over the hinted tile
+    hintMarker.setSize(sf::Vector2f(TILE_SIZE - 4, TILE_SIZE - 4));
+    hintMarker.setFillColor(sf::Color::Transparent);
+    hintMarker.setOutlineThickness(2);
+
+    // Buttons never move, so their hit rectangles are computed once
+    buttonHits[0] = {happyFace.getGlobalBounds(), Button::Face};
+    buttonHits[1] = {debugButton.getGlobalBounds(), Button::Debug};
+    buttonHits[2] = {pauseButton.getGlobalBounds(), Button::Pause};
+    buttonHits[3] = {leaderboardButton.getGlobalBounds(), Button::Leaderboard};
+    buttonHits[4] = {hintButton.getGlobalBounds(), Button::Hint};
+
     // Initialize digit sprites for timer
     for (int i = 0; i < 3; ++i) { // Timer is displayed using 3 digits (max value 999)
-        sf::Sprite digit(digitsTexture, sf::IntRect(0, 0, 21, 32)); // Initial texture rect for digit '0'
+        sf::Sprite digit(atlas.getTexture(), digitRect(0)); // Initial texture rect for digit '0'
         digit.setPosition(((columns * TILE_SIZE) - 97) + i * 21, rows * TILE_SIZE + 16); // Timer digits' position
         timerDigits.push_back(digit);
     }
 
     // Initialize digit sprites for counter
     for (int i = 0; i < 3; ++i) { // Counter is displayed using 3 digits (max value 999)
-        sf::Sprite digit(digitsTexture, sf::IntRect(0, 0, 21, 32)); // Initial texture rect for digit '0'
+        sf::Sprite digit(atlas.getTexture(), digitRect(0)); // Initial texture rect for digit '0'
         digit.setPosition(33 + i * 21, (rows * TILE_SIZE) + 16); // Counter digits' position
         counterDigits.push_back(digit);
     }
 
-    // Initialize the board and game logic
-    createBoard();
-    placeMines();
-    calculateAdjacentMines();
+    // Timing overlay text, shown with F3
+    telemetryText.setFont(font);
+    telemetryText.setCharacterSize(12);
+    telemetryText.setFillColor(sf::Color::Black);
+    telemetryText.setPosition(4, 4);
 
     // Set initial counter and timer values
-    updateCounterDisplay(currentCounter);
+    updateCounterDisplay(engine.getRemainingMines());
     updateTimerDisplay(0); // Start timer at 0
+    solver.reset(engine);
+    replay.begin(engine);
 }
 
 
 
 
-GameWindow::Tile::Tile(float x, float y, sf::Texture& hiddenTexture, sf::Texture& revealedTexture, sf::Texture* numberTextures)
-    : backgroundSprite(hiddenTexture), numberTextures(numberTextures), isRevealed(false), isFlagged(false), isMine(false) {
-    backgroundSprite.setPosition(x, y);
-    sprite.setPosition(x, y);
-}
-
-
-void GameWindow::Tile::reveal(sf::Texture& revealedTexture, sf::Texture& mineTexture, sf::Texture* numberTextures, int number) {
-    isRevealed = true;
-
-    // Always update the background texture
-    backgroundSprite.setTexture(revealedTexture);
-
-    // Update the foreground texture and maintain position
-    if (isMine) {
-        sprite.setTexture(mineTexture); // Set mine texture
-    } else if (number > 0) {
-        sprite.setTexture(numberTextures[number - 1]); // Set number texture
-    } else {
-        sprite.setTexture(revealedTexture); // Blank tile for empty revealed tiles
-    }
-
-    // Ensure the foreground sprite maintains the correct position
-    sprite.setPosition(backgroundSprite.getPosition());
-    std::cout << "Tile revealed at position (" << row << ", " << col << ") with adjacent mines: " << number << "\n";
-}
-
-
-void GameWindow::revealNeighbors(Tile& tile) {
-    // Mark the tile as revealed
-    tile.isRevealed = true;
-
-    int tileRow = tile.row;
-    int tileCol = tile.col;
-
-    std::cout << "Processing tile at (" << tileRow << ", " << tileCol << ")\n";
-
-    // Iterate over the 8 possible neighbors
-    for (int dr = -1; dr <= 1; ++dr) {
-        for (int dc = -1; dc <= 1; ++dc) {
-            // Skip the center tile itself
-            if (dr == 0 && dc == 0) continue;
-
-            int neighborRow = tileRow + dr;
-            int neighborCol = tileCol + dc;
-
-            // Skip out-of-bounds tiles
-            if (neighborRow < 0 || neighborRow >= rows || neighborCol < 0 || neighborCol >= columns) {
-                continue;
-            }
-
-            Tile& neighbor = board[neighborRow][neighborCol];
+void GameWindow::handleWin() {
+    // Update the Happy Face to the sunglasses win face
+    happyFace.setTextureRect(winFaceRect);
 
-            // Skip already revealed or flagged tiles
-            if (neighbor.isRevealed || neighbor.isFlagged) continue;
+    // The timer is already stopped, use its final value
+    elapsedTime = static_cast<int>(getGameTime().asSeconds());
 
-            // Reveal the neighbor
-            neighbor.reveal(revealedTexture, mineTexture, numberTextures, neighbor.adjacentMines);
-            std::cout << "Revealed neighbor at (" << neighborRow << ", " << neighborCol << ") with "
-                      << neighbor.adjacentMines << " adjacent mines\n";
+    // Add the player's time to the leaderboard
+    leaderboard.update(playerName, elapsedTime);
 
-            // Recursively reveal neighbors if the current neighbor has no adjacent mines
-            if (neighbor.adjacentMines == 0) {
-                revealNeighbors(neighbor);
-            }
-        }
-    }
+    // Show the leaderboard over the board, the game loop keeps running underneath
+    pausedBeforeLeaderboard = true;
+    leaderboard.setVisible(true);
 }
 
 
-
-
-void GameWindow::createBoard() {
-    float tileSize = 32.0f; // Tile size
-    for (int row = 0; row < rows; ++row) {
-        std::vector<Tile> tileRow;
-        for (int col = 0; col < columns; ++col) {
-            Tile tile(col * tileSize, row * tileSize, hiddenTexture, revealedTexture, numberTextures);
-            tile.row = row; // Explicitly set the row
-            tile.col = col; // Explicitly set the column
-            tile.backgroundSprite.setPosition(col * tileSize, row * tileSize);
-            tile.sprite.setPosition(col * tileSize, row * tileSize);
-            tileRow.push_back(tile);
-        }
-        board.push_back(tileRow);
-    }
+void GameWindow::handleLeftClick(int row, int col) {
+    // Clicking a revealed number chords it, anything else is a plain reveal
+    const Board& board = engine.getBoard();
+    bool revealed = board.inBounds(row, col) && board.at(row, col).isRevealed();
+    GameEngine::Action action = {revealed ? GameEngine::ActionType::Chord : GameEngine::ActionType::Reveal, row, col};
+    applyActions(std::vector<GameEngine::Action>(1, action));
 }
 
 
-
-
-
-
-
-void GameWindow::placeMines() {
-    std::srand(std::time(0)); // Seed for random generation
-    int placedMines = 0;
-
-    while (placedMines < mines) {
-        int randomRow = std::rand() % rows;
-        int randomCol = std::rand() % columns;
-
-        // Check if the tile is already a mine
-        if (!board[randomRow][randomCol].isMine) {
-            board[randomRow][randomCol].isMine = true;
-
-            // Assign mine texture to the tile
-            board[randomRow][randomCol].sprite.setTexture(mineTexture);
-
-            ++placedMines;
-        }
+void GameWindow::applyActions(const std::vector<GameEngine::Action>& actions) {
+    sf::Time now = getGameTime();
+    bool generated = engine.isGenerated();
+    bool changed;
+    {
+        ScopedTimer revealTimer(telemetry, Telemetry::REVEAL);
+        changed = engine.apply(actions);
     }
-}
-
-std::vector<GameWindow::Tile*> GameWindow::getNeighbors(int row, int col) {
-    std::vector<GameWindow::Tile*> neighbors;
-
-    // Iterate over the possible neighbor positions
-    for (int dr = -1; dr <= 1; ++dr) {
-        for (int dc = -1; dc <= 1; ++dc) {
-            if (dr == 0 && dc == 0) continue; // Skip the tile itself
-            int neighborRow = row + dr;
-            int neighborCol = col + dc;
-
-            // Check if the neighbor is within the bounds of the grid
-            if (neighborRow >= 0 && neighborRow < rows &&
-                neighborCol >= 0 && neighborCol < columns) {
-                neighbors.push_back(&board[neighborRow][neighborCol]);
-                }
-        }
-    }
-
-    return neighbors;
-}
-
+    if (!changed) return;
 
+    // Only batches that changed the board are recorded, each is replayed as one batch again
+    replay.record(static_cast<std::uint32_t>(now.asMilliseconds()), actions);
 
-
-
-
-void GameWindow::revealAllMines() {
-    for (auto& row : board) {
-        for (auto& tile : row) {
-            if (tile.isMine && !tile.isRevealed) {
-                tile.reveal(revealedTexture, mineTexture, numberTextures);
-                tile.isRevealed = true;
-            }
-        }
+    if (generated || !engine.isGenerated()) {
+        boardRenderer.update(engine.getChangedCells());
+    } else {
+        boardRenderer.rebuild(); // Mines were only placed by this batch
     }
-}
+    solver.update(engine, engine.getChangedCells());
+    hintCell = -1;
+    if (showProbabilities) updateProbabilityOverlay();
 
+    // Update the counter display
+    updateCounterDisplay(engine.getRemainingMines());
+    needsRedraw = true;
 
-bool GameWindow::checkWinCondition() {
-    for (const auto& row : board) {
-        for (const auto& tile : row) {
-            if (!tile.isMine && !tile.isRevealed) {
-                return false; // The player hasn't revealed all non-mine tiles
-            }
-        }
+    if (engine.isOver()) {
+        pauseTime = now; // Stop the timer
+        saveReplay();
     }
-    gameEnded = true;
-
-    // Update the Happy Face to the sunglasses win face
-    happyFace.setTexture(winFaceTexture);
-
-    // Stop the timer
-    elapsedTime = static_cast<int>(gameClock.getElapsedTime().asSeconds());
-
-    // Add the player's time to the leaderboard
-    leaderboard.update(playerName, elapsedTime);
-
-    // Display the leaderboard
-    leaderboard.display(window);
-
-    return true;
-}
-
+    autosave(engine.isOver()); // A finished game is saved as such, so it is not resumed
 
-
-
-void GameWindow::calculateAdjacentMines() {
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < columns; ++col) {
-            if (board[row][col].isMine) continue;
-
-            int mineCount = 0;
-            for (int dr = -1; dr <= 1; ++dr) {
-                for (int dc = -1; dc <= 1; ++dc) {
-                    int r = row + dr, c = col + dc;
-                    if (r >= 0 && r < rows && c >= 0 && c < columns && board[r][c].isMine) {
-                        ++mineCount;
-                    }
-                }
-            }
-            board[row][col].adjacentMines = mineCount;
-            std::cout << "Tile at (" << row << ", " << col << ") has " << mineCount << " adjacent mines.\n";
-        }
+    if (engine.isLost()) {
+        happyFace.setTextureRect(loseFaceRect);
+    } else if (engine.isWon()) {
+        handleWin();
     }
 }
 
 
 
 
-void GameWindow::handleLeftClick(Tile& tile) {
-    if (gameEnded || tile.isFlagged || tile.isRevealed) return;
 
-    if (tile.isMine) {
-        tile.reveal(revealedTexture, mineTexture, numberTextures);
-        revealAllMines();
-        gameEnded = true;
-        happyFace.setTexture(loseFaceTexture);
-    } else {
-        tile.reveal(revealedTexture, mineTexture, numberTextures, tile.adjacentMines);
-
-        if (tile.adjacentMines == 0) {
-            std::cout << "Tile has no adjacent mines. Revealing neighbors...\n";
-            revealNeighbors(tile);
-        }
-
-        if (checkWinCondition()) {
-            gameEnded = true;
-            happyFace.setTexture(winFaceTexture);
-        }
-    }
+sf::IntRect GameWindow::digitRect(int digit) const {
+    // Each digit is 21x32 pixels, laid out left to right in the digit strip
+    return sf::IntRect(digitsRect.left + digit * 21, digitsRect.top, 21, 32);
 }
 
-
-
-
-
 void GameWindow::updateCounter(int value) {
     // Convert the value to a string (handle negatives)
     std::string valueStr = (value < 0 ? "-" : "") + std::to_string(std::abs(value));
@@ -334,10 +214,10 @@ void GameWindow::updateCounter(int value) {
     // Render the digits (and handle the '-' sign if present)
     for (size_t i = 0; i < valueStr.size(); ++i) {
         if (valueStr[i] == '-') {
-            counterDigits[i].setTextureRect(sf::IntRect(10 * 21, 0, 21, 32)); // '-' is the 11th sprite
+            counterDigits[i].setTextureRect(digitRect(10)); // '-' is the 11th sprite
         } else {
             int digitIndex = valueStr[i] - '0';
-            counterDigits[i].setTextureRect(sf::IntRect(digitIndex * 21, 0, 21, 32));
+            counterDigits[i].setTextureRect(digitRect(digitIndex));
         }
     }
 }
@@ -354,50 +234,30 @@ void GameWindow::updateCounterDisplay(int counter) {
     int ones = counter % 10;
 
     if (isNegative) {
-        counterDigits[0].setTextureRect(sf::IntRect(10 * 21, 0, 21, 32)); // '-' sprite
-        counterDigits[1].setTextureRect(sf::IntRect(tens * 21, 0, 21, 32));
-        counterDigits[2].setTextureRect(sf::IntRect(ones * 21, 0, 21, 32));
+        counterDigits[0].setTextureRect(digitRect(10)); // '-' sprite
+        counterDigits[1].setTextureRect(digitRect(tens));
+        counterDigits[2].setTextureRect(digitRect(ones));
     } else {
-        counterDigits[0].setTextureRect(sf::IntRect(hundreds * 21, 0, 21, 32));
-        counterDigits[1].setTextureRect(sf::IntRect(tens * 21, 0, 21, 32));
-        counterDigits[2].setTextureRect(sf::IntRect(ones * 21, 0, 21, 32));
+        counterDigits[0].setTextureRect(digitRect(hundreds));
+        counterDigits[1].setTextureRect(digitRect(tens));
+        counterDigits[2].setTextureRect(digitRect(ones));
     }
 }
 
 
 
 
-void GameWindow::handleRightClick(Tile& tile) {
-    if (!tile.isRevealed) {
-        tile.isFlagged = !tile.isFlagged;
-
-        // Adjust the counter
-        if (tile.isFlagged) {
-            currentCounter--;
-        } else {
-            currentCounter++;
-        }
-
-        // Update the counter display
-        updateCounterDisplay(currentCounter);
-
-        tile.sprite.setTexture(tile.isFlagged ? flagTexture : hiddenTexture);
-    }
-}
-void GameWindow::Tile::reset(const sf::Texture& hiddenTexture) {
-    isRevealed = false;
-    isFlagged = false;
-    isMine = false;
-    adjacentMines = 0;
-    backgroundSprite.setTexture(hiddenTexture); // Reset background to hidden texture
-    sprite.setTexture(hiddenTexture);          // Reset foreground to default
+void GameWindow::handleRightClick(int row, int col) {
+    GameEngine::Action action = {GameEngine::ActionType::Flag, row, col};
+    applyActions(std::vector<GameEngine::Action>(1, action));
 }
 
 
 
 void GameWindow::resetGame() {
+    ScopedTimer resetTimer(telemetry, Telemetry::RESET);
+
     // Reset game state
-    gameEnded = false;
     paused = false;
     debugMode = false;
 
@@ -406,118 +266,224 @@ void GameWindow::resetGame() {
     pauseTime = sf::Time::Zero;
     gameClock.restart();
 
+    // Reset the engine (new mine layout)
+    engine.reset();
+    boardRenderer.setDebugMode(false);
+    boardRenderer.rebuild();
+    solver.reset(engine);
+    replay.begin(engine);
+    replayComplete = true;
+    hintCell = -1;
+    if (showProbabilities) updateProbabilityOverlay();
+
     // Reset counter
-    currentCounter = mines;
-    updateCounterDisplay(currentCounter);
+    updateCounterDisplay(engine.getRemainingMines());
 
-    // Reset board
-    for (auto& row : board) {
-        for (auto& tile : row) {
-            tile.reset(hiddenTexture); // Pass the hiddenTexture to reset the tile
-        }
+    // Reset happy face and pause button textures
+    happyFace.setTextureRect(happyFaceRect);
+    pauseButton.setTextureRect(pauseRect);
+    updateTimerDisplay(0);
+
+    LOG_INFO("Game reset successfully");
+}
+
+
+
+
+void GameWindow::toggleDebugMode() {
+    debugMode = !debugMode; // Toggle debug mode
+    boardRenderer.setDebugMode(debugMode);
+    needsRedraw = true;
+    LOG_INFO("Debug mode toggled: %s", debugMode ? "ON" : "OFF");
+}
+
+
+void GameWindow::showHint() {
+    if (paused || engine.isOver()) return;
+
+    // Prefer a safe cell, the player can act on it directly
+    const std::vector<int>& safeCells = solver.getSafeCells();
+    const std::vector<int>& mineCells = solver.getMineCells();
+    if (!safeCells.empty()) {
+        hintCell = safeCells.front();
+        hintMarker.setOutlineColor(sf::Color(0, 160, 0));
+    } else if (!mineCells.empty()) {
+        hintCell = mineCells.front();
+        hintMarker.setOutlineColor(sf::Color(200, 0, 0));
+    } else {
+        LOG_INFO("No provable move, a guess is needed");
+        return;
     }
 
-    // Place mines and calculate adjacent mine counts
-    placeMines();
-    calculateAdjacentMines();
+    const Board& board = engine.getBoard();
+    hintMarker.setPosition(board.colOf(hintCell) * TILE_SIZE + 2, board.rowOf(hintCell) * TILE_SIZE + 2);
+    needsRedraw = true;
+}
 
-    // Reset happy face button texture
-    happyFace.setTexture(happyFaceTexture);
 
-    std::cout << "Game reset successfully.\n";
+void GameWindow::toggleAutoPlay() {
+    autoPlay = !autoPlay;
+    hintLabel.setString(autoPlay ? "Auto" : "Hint"); // The hint button shows when auto-play is on
+    needsRedraw = true;
+    LOG_INFO("Auto-play toggled: %s", autoPlay ? "ON" : "OFF");
+    runAutoPlay();
 }
 
 
+void GameWindow::runAutoPlay() {
+    if (paused) return;
 
+    // Play every provable move, including the ones opened up by earlier moves. Each round goes
+    // to the engine as one batch, so the board, solver and overlay are refreshed once per round.
+    while (autoPlay && !engine.isOver() && solver.hasDeductions()) {
+        const Board& board = engine.getBoard();
+        std::vector<GameEngine::Action> actions;
+        for (int index : solver.getMineCells()) {
+            GameEngine::Action action = {GameEngine::ActionType::Flag, board.rowOf(index), board.colOf(index)};
+            actions.push_back(action);
+        }
+        for (int index : solver.getSafeCells()) {
+            GameEngine::Action action = {GameEngine::ActionType::Reveal, board.rowOf(index), board.colOf(index)};
+            actions.push_back(action);
+        }
+        applyActions(actions);
+    }
+}
 
-void GameWindow::toggleDebugMode() {
-    debugMode = !debugMode; // Toggle debug mode
-    std::cout << "Debug mode toggled: " << (debugMode ? "ON" : "OFF") << std::endl;
+
+void GameWindow::updateProbabilityOverlay() {
+    probabilityOverlay.setPrimitiveType(sf::Quads);
+    probabilityOverlay.clear();
+    if (engine.isOver() || !probabilityEngine.compute(engine)) return;
+
+    // Tint each hidden tile: green when it is certainly safe, more red the likelier a mine
+    const Board& board = engine.getBoard();
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (cell.isRevealed() || cell.isFlagged()) continue;
+
+        float probability = probabilityEngine.getProbability(index);
+        sf::Color color = probability <= 0.0f ? sf::Color(0, 200, 0, 120)
+                                              : sf::Color(255, 0, 0, static_cast<sf::Uint8>(30 + probability * 170));
+        float x = board.colOf(index) * TILE_SIZE;
+        float y = board.rowOf(index) * TILE_SIZE;
+        probabilityOverlay.append(sf::Vertex(sf::Vector2f(x, y), color));
+        probabilityOverlay.append(sf::Vertex(sf::Vector2f(x + TILE_SIZE, y), color));
+        probabilityOverlay.append(sf::Vertex(sf::Vector2f(x + TILE_SIZE, y + TILE_SIZE), color));
+        probabilityOverlay.append(sf::Vertex(sf::Vector2f(x, y + TILE_SIZE), color));
+    }
+    LOG_DEBUG("Mine probabilities: %d components, %d cached, safest cell %d",
+              probabilityEngine.getComponentCount(), probabilityEngine.getCacheHits(), probabilityEngine.getSafestCell());
 }
 
 
 void GameWindow::togglePause() {
-    if (gameEnded) return; // Do nothing if the game has ended
+    if (engine.isOver()) return; // Do nothing if the game has ended
 
     if (paused) {
         // Resume the game
         paused = false;
-        pauseButton.setTexture(pauseTexture); // Switch to pause sprite
+        pauseButton.setTextureRect(pauseRect); // Switch to pause sprite
         gameClock.restart(); // Restart the clock
     } else {
         // Pause the game
         paused = true;
-        pauseButton.setTexture(playTexture); // Switch to play sprite
-        pauseTime = gameClock.getElapsedTime(); // Store elapsed time
+        pauseButton.setTextureRect(playRect); // Switch to play sprite
+        pauseTime += gameClock.getElapsedTime(); // Accumulate elapsed time
+        autosave(true);
     }
+    needsRedraw = true;
 
-    std::cout << (paused ? "Game paused\n" : "Game resumed\n");
+    LOG_INFO("%s", paused ? "Game paused" : "Game resumed");
 }
 
 
 
 
 void GameWindow::showLeaderboard() {
-    // Implement leaderboard display
-    std::cout << "Leaderboard shown\n";
+    if (leaderboard.isVisible()) {
+        leaderboard.setVisible(false);
+        if (!pausedBeforeLeaderboard && paused) togglePause(); // Resume the game if it wasn't paused before
+    } else {
+        pausedBeforeLeaderboard = paused;  // Save the paused state
+        if (!paused) togglePause(); // Pause the game if not already paused
+        leaderboard.setVisible(true);
+    }
+    needsRedraw = true;
 }
 
-void GameWindow::handleMouseClick(const sf::Event::MouseButtonEvent& mouseButton) {
-    sf::Vector2f mousePos(mouseButton.x, mouseButton.y);
+bool GameWindow::tileAt(sf::Vector2f position, int& row, int& col) const {
+    // The tile under the cursor follows directly from the tile grid
+    if (position.x < 0 || position.y < 0) return false;
+    row = static_cast<int>(position.y / TILE_SIZE);
+    col = static_cast<int>(position.x / TILE_SIZE);
+    return engine.inBounds(row, col);
+}
 
-    if (mouseButton.button == sf::Mouse::Left) {
-        // Check for happy face button click
-        if (happyFace.getGlobalBounds().contains(mousePos)) {
-            std::cout << "Happy face clicked!\n";
-            resetGame();
-            return; // Exit function to avoid unnecessary checks
-        }
+GameWindow::Button GameWindow::buttonAt(sf::Vector2f position) const {
+    // Buttons only live in the HUD strip below the board
+    if (position.y < rows * TILE_SIZE) return Button::None;
 
-        // Check for debug button click (only allowed if game is not paused)
-        if (!paused && debugButton.getGlobalBounds().contains(mousePos)) {
-            std::cout << "Debug button clicked!\n";
-            toggleDebugMode();
-            return;
-        }
+    for (const ButtonHit& hit : buttonHits) {
+        if (hit.bounds.contains(position)) return hit.button;
+    }
+    return Button::None;
+}
 
-        // Check for pause button click
-        if (pausePlayButton.getGlobalBounds().contains(mousePos)) {
-            std::cout << (paused ? "Resume button clicked!\n" : "Pause button clicked!\n");
-            togglePause();
-            return;
-        }
+void GameWindow::handleMouseClick(const sf::Event::MouseButtonEvent& mouseButton) {
+    sf::Vector2f mousePos(mouseButton.x, mouseButton.y);
 
-        // Check for leaderboard button click
-        if (leaderboardButton.getGlobalBounds().contains(mousePos)) {
-            if (!paused) togglePause(); // Automatically pause the game before showing leaderboard
-            std::cout << "Leaderboard button clicked!\n";
-            showLeaderboard();
-            return;
-        }
+    // While the leaderboard overlay is open, any click closes it
+    if (leaderboard.isVisible()) {
+        showLeaderboard();
+        return;
+    }
 
-        // Handle tile clicks only if the game is not paused or ended
-        if (!paused && !gameEnded) {
-            for (auto& row : board) {
-                for (auto& tile : row) {
-                    if (tile.backgroundSprite.getGlobalBounds().contains(mousePos)) {
-                        handleLeftClick(tile); // Handle left click on tile
-                        return;
-                    }
-                }
-            }
+    // Handle tile clicks only if the game is not paused
+    int row, col;
+    if (tileAt(mousePos, row, col)) {
+        if (paused) return;
+
+        if (mouseButton.button == sf::Mouse::Left) {
+            handleLeftClick(row, col);
+        } else if (mouseButton.button == sf::Mouse::Right) {
+            handleRightClick(row, col);
+        } else if (mouseButton.button == sf::Mouse::Middle) {
+            GameEngine::Action action = {GameEngine::ActionType::Chord, row, col};
+            applyActions(std::vector<GameEngine::Action>(1, action));
         }
+        runAutoPlay();
+        return;
     }
-}
 
+    // Buttons only react to the left mouse button
+    if (mouseButton.button != sf::Mouse::Left) return;
 
-void GameWindow::Tile::toggleFlag(sf::Texture& flagTexture, sf::Texture& hiddenTexture) {
-    isFlagged = !isFlagged;
-    foregroundSprite.setTexture(isFlagged ? flagTexture : sf::Texture()); // Set flag texture if flagged, otherwise clear
+    switch (buttonAt(mousePos)) {
+        case Button::Leaderboard:
+            showLeaderboard();
+            break;
+        case Button::Pause:
+            togglePause(); // Allow pause button interaction even if paused
+            break;
+        case Button::Face:
+            if (!paused) resetGame();
+            break;
+        case Button::Debug:
+            if (!paused) toggleDebugMode();
+            break;
+        case Button::Hint:
+            showHint();
+            break;
+        case Button::None:
+            break;
+    }
 }
 
 
 void GameWindow::updateTimerDisplay(int time) {
     timerDigits.clear(); // Clear previous digit sprites
+    needsRedraw = true;
 
     // Calculate minutes and seconds
     int minutes = time / 60;
@@ -532,8 +498,8 @@ void GameWindow::updateTimerDisplay(int time) {
         int digit = minuteStr[i] - '0';
 
         sf::Sprite digitSprite;
-        digitSprite.setTexture(digitsTexture);
-        digitSprite.setTextureRect(sf::IntRect(digit * 21, 0, 21, 32)); // Each digit is 21x32 pixels
+        digitSprite.setTexture(atlas.getTexture());
+        digitSprite.setTextureRect(digitRect(digit)); // Each digit is 21x32 pixels
         digitSprite.setPosition((columns * 32) - 97 + (i * 21), 32 * (rows + 0.5) + 16);
         timerDigits.push_back(digitSprite);
     }
@@ -543,8 +509,8 @@ void GameWindow::updateTimerDisplay(int time) {
         int digit = secondStr[i] - '0';
 
         sf::Sprite digitSprite;
-        digitSprite.setTexture(digitsTexture);
-        digitSprite.setTextureRect(sf::IntRect(digit * 21, 0, 21, 32)); // Each digit is 21x32 pixels
+        digitSprite.setTexture(atlas.getTexture());
+        digitSprite.setTextureRect(digitRect(digit)); // Each digit is 21x32 pixels
         digitSprite.setPosition((columns * 32) - 54 + (i * 21), 32 * (rows + 0.5) + 16);
         timerDigits.push_back(digitSprite);
     }
@@ -553,117 +519,244 @@ void GameWindow::updateTimerDisplay(int time) {
 
 
 
-void GameWindow::run() {
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-            } else if (event.type == sf::Event::MouseButtonPressed) {
-                sf::Vector2f mousePos(event.mouseButton.x, event.mouseButton.y);
-
-                // Check if the leaderboard button is clicked
-                if (leaderboardButton.getGlobalBounds().contains(mousePos)) {
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        bool wasPaused = paused;  // Save the paused state
-                        if (!paused) togglePause(); // Pause the game if not already paused
-                        leaderboardOpen = true;
-                        leaderboard.display(window);
-                        leaderboardOpen = false;
-                        if (!wasPaused) togglePause(); // Resume the game if it wasn't paused before
-                        continue;
-                    }
-                }
-
-                // Allow pause button interaction even if paused
-                if (pauseButton.getGlobalBounds().contains(mousePos)) {
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        togglePause();
-                        continue;
-                    }
-                }
-
-                // Skip all other interactions if paused or leaderboard is open
-                if (paused || leaderboardOpen) continue;
-
-                // Handle other buttons
-                if (happyFace.getGlobalBounds().contains(mousePos)) {
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        resetGame();
-                        continue;
-                    }
-                }
-
-                if (debugButton.getGlobalBounds().contains(mousePos)) {
-                    if (event.mouseButton.button == sf::Mouse::Left) {
-                        toggleDebugMode();
-                        continue;
-                    }
-                }
-
-                // Check tile interactions
-                for (auto& row : board) {
-                    for (auto& tile : row) {
-                        if (tile.backgroundSprite.getGlobalBounds().contains(mousePos)) {
-                            if (event.mouseButton.button == sf::Mouse::Left) {
-                                handleLeftClick(tile);
-                            } else if (event.mouseButton.button == sf::Mouse::Right) {
-                                handleRightClick(tile);
-
-                                // Update the counter when a flag is toggled
-                                updateCounterDisplay(currentCounter);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+// Waits up to `timeout` for the next event, checking for one every `slice`. SFML has no timed
+// wait, and its own waitEvent() polls every 10 ms as well. Returns false if the timeout expired first.
+static bool waitEventFor(sf::RenderWindow& window, sf::Event& event, sf::Time timeout, sf::Time slice) {
+    sf::Clock waited;
+    while (!window.pollEvent(event)) {
+        sf::Time left = timeout - waited.getElapsedTime();
+        if (left <= sf::Time::Zero) return false;
+        sf::sleep(left < slice ? left : slice);
+    }
+    return true;
+}
+
 
-        if (!paused && !gameEnded) {
-            elapsedTime = pauseTime.asSeconds() + gameClock.getElapsedTime().asSeconds();
-            updateTimerDisplay(static_cast<int>(elapsedTime)); // Update timer digits
-        } else if (paused) {
-            elapsedTime = pauseTime.asSeconds(); // Freeze the timer at the paused value
-            updateTimerDisplay(static_cast<int>(elapsedTime)); // Display the frozen time
+sf::Time GameWindow::getGameTime() const {
+    if (paused || engine.isOver()) return pauseTime; // Frozen while paused and after the game ends
+    return pauseTime + gameClock.getElapsedTime();
+}
+
+
+void GameWindow::handleEvent(const sf::Event& event) {
+    // Remember when the first input of this frame arrived, for the input latency metric
+    if ((event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::KeyPressed) && !inputPending) {
+        inputPending = true;
+        inputTime = Telemetry::Clock::now();
+    }
+
+    if (event.type == sf::Event::Closed) {
+        window.close();
+    } else if (event.type == sf::Event::LostFocus) {
+        focused = false;
+    } else if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+        if (event.type == sf::Event::GainedFocus) focused = true;
+        needsRedraw = true; // The window contents may have been lost
+    } else if (event.type == sf::Event::MouseButtonPressed) {
+        handleMouseClick(event.mouseButton);
+    } else if (event.type == sf::Event::KeyPressed && leaderboard.isVisible()) {
+        // The open leaderboard takes the keyboard: paging keys flip pages, Escape closes it
+        if (event.key.code == sf::Keyboard::Escape) {
+            showLeaderboard();
+        } else if (leaderboard.handleKey(event.key.code)) {
+            needsRedraw = true;
         }
+    } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+        showTelemetry = !showTelemetry; // Toggle the timing overlay
+        needsRedraw = true;
+    } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H) {
+        showHint();
+    } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+        toggleAutoPlay();
+    } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+        showProbabilities = !showProbabilities; // Toggle the mine probability overlay
+        if (showProbabilities) updateProbabilityOverlay();
+        needsRedraw = true;
+    }
+}
+
+
+void GameWindow::setTelemetryOutput(const std::string& file) {
+    telemetryOutput = file;
+}
+
+
+void GameWindow::setReplayOutput(const std::string& file) {
+    replayOutput = file;
+}
+
+
+void GameWindow::saveReplay() {
+    if (replayOutput.empty() || !replayComplete) return;
+
+    replay.finish(engine);
+    if (replay.append(replayOutput)) {
+        LOG_INFO("Replay with %zu actions appended to %s", replay.getEvents().size(), replayOutput.c_str());
+    } else {
+        LOG_ERROR("Failed to append replay to %s", replayOutput.c_str());
+    }
+}
 
 
-        // Render everything
-        window.clear(sf::Color::White);
+void GameWindow::setSaveFile(const std::string& file) {
+    saveFile = file;
+}
+
+
+void GameWindow::autosave(bool force) {
+    if (saveFile.empty()) return;
+
+    // Only the state is copied here, the file is written on the autosaver's thread
+    Telemetry::Clock::time_point now = Telemetry::Clock::now();
+    if (!force && now - lastAutosave < AUTOSAVE_INTERVAL) return;
+    lastAutosave = now;
+    autosaver.save(engine, static_cast<std::uint64_t>(getGameTime().asMilliseconds()), saveFile);
+}
+
+
+bool GameWindow::resume(const SnapshotFile& snapshot) {
+    if (!snapshot.isOpen()) return false;
+    const SnapshotHeader& header = snapshot.getHeader();
+    if (header.columns != engine.getColumns() || header.rows != engine.getRows() || header.mines != engine.getMines() ||
+        snapshot.getGeneration() != engine.getGeneration() || !engine.restore(snapshot.getSavedState())) {
+        LOG_WARN("Saved game does not fit this board, starting a new one");
+        return false;
+    }
+
+    // Continue the clock where it stopped
+    paused = false;
+    pauseTime = sf::milliseconds(static_cast<sf::Int32>(header.elapsedMilliseconds));
+    gameClock.restart();
+    elapsedTime = static_cast<int>(pauseTime.asSeconds());
+    updateTimerDisplay(elapsedTime);
+
+    boardRenderer.rebuild();
+    solver.reset(engine);
+    replayComplete = false;
+    hintCell = -1;
+    if (showProbabilities) updateProbabilityOverlay();
+    updateCounterDisplay(engine.getRemainingMines());
+    needsRedraw = true;
+
+    LOG_INFO("Resumed a saved game at %d seconds", elapsedTime);
+    return true;
+}
 
-        // Draw the board
-        for (const auto& row : board) {
-            for (const auto& tile : row) {
-                window.draw(tile.backgroundSprite); // Draw background
 
-                if (tile.isRevealed || tile.isFlagged) {
-                    window.draw(tile.sprite); // Draw foreground if revealed or flagged
-                }
+void GameWindow::render() {
+    window.clear(sf::Color::White);
 
-                // If debug mode is active, reveal all mines
-                if (debugMode && tile.isMine) {
-                    window.draw(tile.sprite);
-                }
+    // Draw the board, one draw call per layer
+    window.draw(boardRenderer);
+    if (showProbabilities && !paused) {
+        window.draw(probabilityOverlay);
+    }
+
+    // Draw the counter digits
+    for (const auto& digit : counterDigits) {
+        window.draw(digit);
+    }
+
+    // Draw the timer digits
+    for (const auto& digit : timerDigits) {
+        window.draw(digit);
+    }
+
+    // Draw the buttons
+    window.draw(happyFace);
+    window.draw(debugButton);
+    window.draw(pauseButton);
+    window.draw(leaderboardButton);
+    window.draw(hintButton);
+    window.draw(hintLabel);
+
+    // Outline the hinted tile
+    if (hintCell >= 0) {
+        window.draw(hintMarker);
+    }
+
+    // The leaderboard overlay is one textured quad, drawn only while it is open
+    window.draw(leaderboard);
+
+    // Draw the timing overlay on top of the board
+    if (showTelemetry) {
+        telemetryText.setString(telemetry.summary());
+        sf::FloatRect bounds = telemetryText.getGlobalBounds();
+        sf::RectangleShape background(sf::Vector2f(bounds.left + bounds.width + 8, bounds.top + bounds.height + 8));
+        background.setFillColor(sf::Color(255, 255, 255, 200));
+        window.draw(background);
+        window.draw(telemetryText);
+    }
+}
+
+
+void GameWindow::run() {
+    while (window.isOpen()) {
+        sf::Event event;
+
+        // Block until something happens: an event, or the next whole second while the clock runs.
+        // The timer is the only thing that moves on its own; while the game is paused or over
+        // nothing does, so the wait blocks outright. A window in the background is checked ten
+        // times a second instead of a hundred, as it gets no clicks or keys until it is focused.
+        bool gotEvent = false;
+        if (!needsRedraw) {
+            if (!paused && !engine.isOver()) {
+                float now = getGameTime().asSeconds();
+                sf::Time slice = sf::milliseconds(focused ? 10 : 100);
+                gotEvent = waitEventFor(window, event, sf::seconds(std::floor(now) + 1.0f - now), slice);
+            } else {
+                gotEvent = window.waitEvent(event);
             }
         }
 
-        // Draw the counter digits
-        for (const auto& digit : counterDigits) {
-            window.draw(digit);
+        // The frame starts once the wait is over
+        Telemetry::Clock::time_point frameStart = Telemetry::Clock::now();
+        if (gotEvent) {
+            handleEvent(event);
+        }
+
+        // Handle everything else that is already queued
+        while (window.pollEvent(event)) {
+            handleEvent(event);
+        }
+
+        // Only touch the timer digits when the displayed second changes
+        int time = static_cast<int>(getGameTime().asSeconds());
+        if (time != elapsedTime) {
+            elapsedTime = time;
+            updateTimerDisplay(elapsedTime);
         }
 
-        // Draw the timer digits
-        for (const auto& digit : timerDigits) {
-            window.draw(digit);
+        // Redraw only when the board or HUD was invalidated
+        if (needsRedraw && window.isOpen()) {
+            Telemetry::Clock::time_point renderStart = Telemetry::Clock::now();
+            render();
+            Telemetry::Clock::time_point presentStart = Telemetry::Clock::now();
+            window.display();
+            Telemetry::Clock::time_point frameEnd = Telemetry::Clock::now();
+            needsRedraw = false;
+
+            telemetry.record(Telemetry::UPDATE, renderStart - frameStart);
+            telemetry.record(Telemetry::RENDER, presentStart - renderStart);
+            telemetry.record(Telemetry::PRESENT, frameEnd - presentStart);
+            telemetry.record(Telemetry::FRAME, frameEnd - frameStart);
+            if (inputPending) {
+                telemetry.record(Telemetry::INPUT_LATENCY, frameEnd - inputTime);
+            }
         }
+        inputPending = false; // Input that changed nothing on screen has no latency to report
+    }
 
-        // Draw the buttons
-        window.draw(happyFace);
-        window.draw(debugButton);
-        window.draw(pauseButton);
-        window.draw(leaderboardButton);
+    // Save the game as it was left, and make sure it is on disk before exiting
+    autosave(true);
+    autosaver.wait();
 
-        // Display everything
-        window.display();
+    // Dump the timing histograms on exit
+    if (!telemetryOutput.empty()) {
+        if (telemetry.write(telemetryOutput)) {
+            LOG_INFO("Telemetry written to %s", telemetryOutput.c_str());
+        } else {
+            LOG_ERROR("Failed to write telemetry to %s", telemetryOutput.c_str());
+        }
     }
 }
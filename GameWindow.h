@@ -2,25 +2,38 @@
 #define GAME_WINDOW_H
 
 
+#include "BoardRenderer.h"
+#include "GameEngine.h"
 #include "LeaderBoard.h"
+#include "ProbabilityEngine.h"
+#include "Replay.h"
+#include "Snapshot.h"
+#include "Solver.h"
+#include "Telemetry.h"
+#include "TextureAtlas.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <string>
 
 class GameWindow {
 public:
-    GameWindow(int columns, int rows, int mines, const std::string& fontPath, const std::string& imagePath, const std::string& playerName);
+    GameWindow(int columns, int rows, int mines, const std::string& fontPath, const std::string& imagePath, const std::string& playerName,
+               GameEngine::Generation generation = GameEngine::Generation::Random);
     void run();
     void resetGame();
     void toggleDebugMode();              
     void togglePause();                 
-    void showLeaderboard();            
+    void showLeaderboard();              // Open the leaderboard overlay, or close it if it is open
+    void showHint();                     // Mark one provably safe cell (or mine) from the solver
+    void toggleAutoPlay();               // Automatically play every provable move
     void handleMouseClick(const sf::Event::MouseButtonEvent& mouseButton); 
     void updateTimerDisplay(int time);
     void updateCounter(int value);
     void updateCounterDisplay(int counter);
-    bool checkWinCondition();
-    void revealAllMines();
+    void setTelemetryOutput(const std::string& file); // Dump timing histograms here on exit (.csv or .json)
+    void setReplayOutput(const std::string& file);    // Append a replay of every finished game to this file
+    void setSaveFile(const std::string& file);        // Autosave the game here at checkpoints and on exit
+    bool resume(const SnapshotFile& snapshot);        // Continue a saved game of this window's size
 
 
 
@@ -29,12 +42,30 @@ private:
     sf::RenderWindow window;
     sf::Font font;
 
-    // Button textures and sprites
-    sf::Texture happyFaceTexture, winFaceTexture, loseFaceTexture, debugTexture, pauseTexture, playTexture, leaderboardTexture;
-    sf::Sprite happyFace, debugButton, pauseButton, leaderboardButton, pausePlayButton;
+    // Every tile, digit and button image packed into one texture
+    TextureAtlas atlas;
 
-    // Tile textures
-    sf::Texture hiddenTexture, revealedTexture, mineTexture, flagTexture, digitsTexture;
+    // Button atlas rects and sprites
+    sf::IntRect happyFaceRect, winFaceRect, loseFaceRect, debugRect, pauseRect, playRect, leaderboardRect;
+    sf::Sprite happyFace, debugButton, pauseButton, leaderboardButton;
+
+    // Hint button, drawn as a labelled box since there is no image for it
+    sf::RectangleShape hintButton;
+    sf::Text hintLabel;
+
+    // Precomputed button hit table
+    enum class Button { None, Face, Debug, Pause, Leaderboard, Hint };
+    struct ButtonHit {
+        sf::FloatRect bounds;
+        Button button;
+    };
+    ButtonHit buttonHits[5];
+    Button buttonAt(sf::Vector2f position) const;
+    bool tileAt(sf::Vector2f position, int& row, int& col) const; // False if outside the board
+
+    // HUD digit strip in the atlas
+    sf::IntRect digitsRect;
+    sf::IntRect digitRect(int digit) const; // Digits 0-9, 10 is the '-' sign
 
     // Timer-related members
     sf::Clock gameClock, timer;
@@ -47,11 +78,29 @@ private:
     // Game state flags
     bool debugMode = false;                
     bool paused = false;                   
-    bool gameEnded = false;               
+    bool needsRedraw = true;             // Set whenever the board or HUD changes
+    bool focused = true;                 // Input only arrives while focused, so waits can be longer without it
+
+    // Frame timing and input latency
+    Telemetry telemetry;
+    bool showTelemetry = false;
+    sf::Text telemetryText;
+    std::string telemetryOutput;
+    bool inputPending = false;
+    Telemetry::Clock::time_point inputTime;
+
+    // Recording of the current game, appended to replayOutput when it ends
+    Replay replay;
+    std::string replayOutput;
+    bool replayComplete = true; // False for a resumed game, its replay would miss the earlier moves
+
+    // Background autosave of the current game
+    SnapshotWriter autosaver;
+    std::string saveFile;
+    Telemetry::Clock::time_point lastAutosave;
 
-    int currentCounter;
     std::vector<sf::Sprite> counterDigits;
-    bool leaderboardOpen = false;  
+    bool pausedBeforeLeaderboard = false; // Pause state to return to when the overlay closes
     sf::RectangleShape leaderboardWindow; 
     bool playerWon = false; 
     bool playerLost = false;
@@ -60,40 +109,32 @@ private:
 
 
 
-    struct Tile {
-        sf::Sprite backgroundSprite; 
-        sf::Sprite foregroundSprite; 
-        sf::Sprite sprite;
-        bool isRevealed = false;
-        bool isFlagged = false;
-        bool isMine = false;
-        int adjacentMines = 0;
-        int row = 0, col = 0;
-        sf::Texture* numberTextures = nullptr;
-
-
-        Tile(float x, float y, sf::Texture& hiddenTexture, sf::Texture& revealedTexture, sf::Texture* numberTextures);
+    GameEngine engine;
+    BoardRenderer boardRenderer; // Cell vertices are derived from the engine state
+    Solver solver;               // Kept up to date after every move, so hints are instant
+    int hintCell = -1;           // Cell marked by the last hint, -1 if none
+    sf::RectangleShape hintMarker;
+    bool autoPlay = false;
 
-        void reveal(sf::Texture& revealedTexture, sf::Texture& mineTexture, sf::Texture* numberTextures, int number = 0);
-        void toggleFlag(sf::Texture& flagTexture, sf::Texture& hiddenTexture);
-        void reset(const sf::Texture& hiddenTexture);
-    };
-
-
-
-    std::vector<std::vector<Tile>> board;
+    // Mine probability overlay, toggled with P
+    ProbabilityEngine probabilityEngine;
+    bool showProbabilities = false;
+    sf::VertexArray probabilityOverlay;
     int columns;
     int rows;
     int mines;
 
-    void createBoard();
-    void placeMines();
-    void calculateAdjacentMines();
-
-    void revealNeighbors(Tile& tile);
-    void handleLeftClick(Tile& tile);
-    void handleRightClick(Tile& tile);
-    std::vector<Tile*> getNeighbors(int row, int col);
+    void handleLeftClick(int row, int col);
+    void handleRightClick(int row, int col);
+    void applyActions(const std::vector<GameEngine::Action>& actions); // One engine batch, then refresh the view once
+    void handleWin();
+    void saveReplay(); // Called once the game is over
+    void autosave(bool force); // Unless forced, at most once per AUTOSAVE_INTERVAL
+    void runAutoPlay();
+    void updateProbabilityOverlay();
+    void handleEvent(const sf::Event& event);
+    void render();                    // Draw the frame, the caller presents it
+    sf::Time getGameTime() const;     // Time played, excluding pauses
 };
 
 #endif // GAME_WINDOW_H
@@ -1,11 +1,13 @@
 #include "LeaderBoard.h"
-#include <fstream>
+#include "Logger.h"
+#include "ScoreFile.h"
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
 
-Leaderboard::Leaderboard(const std::string& fontPath, const std::string& leaderboardFile)
-    : leaderboardFile(leaderboardFile) {
+Leaderboard::Leaderboard(const std::string& fontPath, const std::string& scoreFile, int columns, int rows, int mines) {
     // Load the font
     if (!font.loadFromFile(fontPath)) {
         std::cerr << "Failed to load font from: " << fontPath << std::endl;
@@ -13,112 +15,141 @@ Leaderboard::Leaderboard(const std::string& fontPath, const std::string& leaderb
     }
 
     titleText.setFont(font);
-    titleText.setString("LEADERBOARD");
     titleText.setCharacterSize(20); // Font size for title
     titleText.setStyle(sf::Text::Bold | sf::Text::Underlined);
     titleText.setFillColor(sf::Color::White);
 
+    resultText.setFont(font);
+    resultText.setCharacterSize(14);
+    resultText.setFillColor(sf::Color::White);
+    pageText.setFont(font);
+    pageText.setCharacterSize(12);
+    pageText.setFillColor(sf::Color::White);
 
-    // Load leaderboard data from file
-    loadFromFile();
+    // The overlay is drawn from this texture, so the text is only laid out again when it changes
+    if (!texture.create(WIDTH, HEIGHT)) {
+        std::cerr << "Failed to create the leaderboard texture" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    sprite.setTexture(texture.getTexture(), true);
+
+    // Load every board's scores, this leaderboard shows the ones of its own board
+    key.columns = columns;
+    key.rows = rows;
+    key.mines = mines;
+    if (!store.open(scoreFile)) {
+        LOG_ERROR("Failed to open the score log %s, new scores will not be saved", scoreFile.c_str());
+        setResult("Scores cannot be saved to " + scoreFile);
+    }
     formatEntries();
 }
 
-void Leaderboard::display(sf::RenderWindow& parentWindow) {
-    sf::RenderWindow leaderboardWindow(sf::VideoMode(400, 300), "Leaderboard", sf::Style::Close);
-    titleText.setPosition(200 - (titleText.getGlobalBounds().width / 2), 20); // Center title
-
-    while (leaderboardWindow.isOpen()) {
-        sf::Event event;
-        while (leaderboardWindow.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                leaderboardWindow.close();
-            }
-        }
-
-        leaderboardWindow.clear(sf::Color::Blue);
-
-        // Draw the title and entries
-        leaderboardWindow.draw(titleText);
-        for (const auto& entry : entries) {
-            leaderboardWindow.draw(entry);
-        }
-
-        leaderboardWindow.display();
+bool Leaderboard::handleKey(sf::Keyboard::Key code) {
+    // Left/Right (or Page Up/Down) flip through the pages, Home jumps back to the top, and Tab
+    // switches between the fastest runs and the players' personal bests
+    if (code == sf::Keyboard::Tab) {
+        showBests = !showBests;
+        page = 0;
+        formatEntries();
+        return true;
+    } else if (code == sf::Keyboard::Right || code == sf::Keyboard::PageDown) {
+        return showPage(page + 1);
+    } else if ((code == sf::Keyboard::Left || code == sf::Keyboard::PageUp) && page > 0) {
+        return showPage(page - 1);
+    } else if (code == sf::Keyboard::Home) {
+        return showPage(0);
     }
+    return false;
 }
 
-void Leaderboard::loadFromFile() {
-    std::ifstream file(leaderboardFile);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open leaderboard file: " << leaderboardFile << std::endl;
-        return;
+int Leaderboard::importFile(const std::string& file) {
+    ScoreFile scores;
+    if (!scores.open(file)) {
+        LOG_WARN("Failed to open leaderboard file: %s", file.c_str());
+        return 0;
     }
 
-    scores.clear();
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string timeStr, playerName;
-        if (std::getline(iss, timeStr, ',') && std::getline(iss, playerName)) {
-            int minutes = std::stoi(timeStr.substr(0, 2)); // Extract minutes
-            int seconds = std::stoi(timeStr.substr(3, 2)); // Extract seconds
-            int totalSeconds = minutes * 60 + seconds;
-            scores.push_back({totalSeconds, playerName});
-        }
+    // Parsed in place from the mapped file, then added to the log in one batch
+    std::vector<ScoreFile::Record> records;
+    scores.parse(records);
+    store.beginBatch();
+    for (const ScoreFile::Record& record : records) {
+        store.add(key, record.time, std::string(record.name, record.nameLength));
     }
-    file.close();
-}
-
+    store.endBatch();
 
+    LOG_INFO("Imported %zu scores from %s, skipped %zu malformed lines", records.size(), file.c_str(),
+             scores.getMalformedCount());
+    formatEntries();
+    return static_cast<int>(records.size());
+}
 
-void Leaderboard::saveToFile() {
-    std::ofstream file(leaderboardFile, std::ofstream::trunc); // Open file for writing
-    if (!file.is_open()) {
-        std::cerr << "Failed to open leaderboard file for writing: " << leaderboardFile << std::endl;
-        return;
+// "1,204" style grouping for large counts
+static std::string groupDigits(std::uint64_t value) {
+    std::string digits = std::to_string(value);
+    for (int i = static_cast<int>(digits.size()) - 3; i > 0; i -= 3) {
+        digits.insert(i, ",");
     }
+    return digits;
+}
 
-    int rank = 0; // Track rank to ensure only the top 5 players are written
-    for (const auto& score : scores) {
-        if (rank++ >= 5) break; // Stop writing after 5 players
+static std::string ordinal(std::uint64_t value) {
+    const char* suffix = "th";
+    if (value % 100 < 11 || value % 100 > 13) {
+        if (value % 10 == 1) suffix = "st";
+        else if (value % 10 == 2) suffix = "nd";
+        else if (value % 10 == 3) suffix = "rd";
+    }
+    return groupDigits(value) + suffix;
+}
 
-        std::string playerName = score.second;
-        size_t asteriskPos = playerName.find('*');
-        if (asteriskPos != std::string::npos) {
-            // Remove asterisk from the name
-            playerName = playerName.substr(0, asteriskPos);
-        }
+static std::string formatTime(int time) {
+    std::ostringstream oss;
+    oss << std::setw(2) << std::setfill('0') << time / 60 << ":" << std::setw(2) << std::setfill('0') << time % 60;
+    return oss.str();
+}
 
-        // Write to file in the format "MM:SS,PlayerName"
-        int minutes = score.first / 60;
-        int seconds = score.first % 60;
-        file << std::setw(2) << std::setfill('0') << minutes << ":"
-             << std::setw(2) << std::setfill('0') << seconds << ","
-             << playerName << "\n";
-    }
+size_t Leaderboard::getPageCount() const {
+    size_t shown = showBests ? store.getPlayerCount(key) : store.getKeptCount(key);
+    return shown == 0 ? 1 : (shown + SHOWN_ENTRIES - 1) / SHOWN_ENTRIES;
+}
 
-    file.close();
+bool Leaderboard::showPage(size_t newPage) {
+    newPage = std::min(newPage, getPageCount() - 1);
+    if (newPage == page) return false;
+    page = newPage;
+    formatEntries();
+    return true;
 }
 
+void Leaderboard::setResult(const std::string& text) {
+    resultText.setString(text);
+    sf::FloatRect resultBounds = resultText.getLocalBounds();
+    resultText.setPosition(200 - resultBounds.width / 2.0f, 215);
+}
 
 void Leaderboard::formatEntries() {
     entries.clear();
-    int rank = 1;
+    size_t rank = page * SHOWN_ENTRIES + 1;
     float yOffset = 60.0f;
 
-    for (const auto& score : scores) {
+    // Only the entries on this page are looked up: the kept runs are few, and each personal best
+    // query is logarithmic in the number of scores
+    std::vector<ScoreStore::Entry> shown;
+    if (showBests) {
+        shown = store.playerPage(key, page * SHOWN_ENTRIES, SHOWN_ENTRIES);
+    } else {
+        shown = store.top(key, (page + 1) * SHOWN_ENTRIES);
+        shown.erase(shown.begin(), shown.begin() + std::min(shown.size(), page * SHOWN_ENTRIES));
+    }
+    for (const ScoreStore::Entry& score : shown) {
         sf::Text entry;
         entry.setFont(font);
 
         // Format rank, time in MM:SS, and player name
         std::ostringstream oss;
-        int minutes = score.first / 60; // Convert total seconds to minutes
-        int seconds = score.first % 60; // Convert total seconds to seconds
-        oss << rank++ << ". "
-            << std::setw(2) << std::setfill('0') << minutes << ":" // Format MM
-            << std::setw(2) << std::setfill('0') << seconds << " " // Format SS
-            << score.second; // Include name and asterisk
+        oss << groupDigits(rank++) << ". " << formatTime(score.time) << " "
+            << score.name << (score.sequence == newestSequence ? " *" : ""); // Mark the new score
 
         entry.setString(oss.str());
         entry.setCharacterSize(18);
@@ -132,33 +163,68 @@ void Leaderboard::formatEntries() {
         entries.push_back(entry);
         yOffset += 30.0f; // Space between entries
     }
+
+    titleText.setString(showBests ? "PERSONAL BESTS" : "LEADERBOARD");
+    titleText.setPosition(WIDTH / 2 - (titleText.getGlobalBounds().width / 2), 20); // Center title
+    pageText.setString("Page " + groupDigits(page + 1) + " of " + groupDigits(getPageCount()) +
+                       "  (Left/Right, Tab: " + (showBests ? "fastest runs)" : "personal bests)"));
+    sf::FloatRect pageBounds = pageText.getLocalBounds();
+    pageText.setPosition(200 - pageBounds.width / 2.0f, 275);
+    renderTexture();
 }
 
-void Leaderboard::update(const std::string& playerName, int time) {
-    std::cout << "Updating leaderboard with: " << playerName << ", " << time << " seconds\n";
+void Leaderboard::renderTexture() {
+    texture.clear(sf::Color::Blue);
 
-    // Add new score
-    scores.push_back({time, playerName});
+    // Draw the title, entries and page footer
+    texture.draw(titleText);
+    for (const auto& entry : entries) {
+        texture.draw(entry);
+    }
+    texture.draw(resultText);
+    texture.draw(pageText);
 
-    // Sort scores in ascending order of time
-    std::sort(scores.begin(), scores.end(), [](const std::pair<int, std::string>& a, const std::pair<int, std::string>& b) {
-        return a.first < b.first; // Sort by time
-    });
+    texture.display();
+}
 
-    // Keep only the top 5 scores
-    if (scores.size() > 5) {
-        scores.resize(5);
+void Leaderboard::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (visible) {
+        target.draw(sprite, states);
     }
+}
 
-    // Mark the new score with an asterisk (*)
-    for (auto& score : scores) {
-        if (score.second == playerName && score.first == time) {
-            score.second += " *"; // Add asterisk
-            break;
+void Leaderboard::update(const std::string& playerName, int time) {
+    LOG_INFO("Updating leaderboard with: %s, %d seconds", playerName.c_str(), time);
+
+    // Append the score to the log, the new score is marked with an asterisk (*)
+    newestSequence = store.add(key, time, playerName);
+
+    // Where the score placed among every game on this board, and the player's best so far
+    std::ostringstream oss;
+    std::uint64_t rank = store.getRank(key, time);
+    double percentile = store.getPercentile(key, time);
+    oss << "You placed " << ordinal(rank) << " of " << groupDigits(store.getScoreCount(key))
+        << " (top " << std::setprecision(percentile < 1.0 ? 2 : 3) << percentile << "%)";
+    ScoreStore::Entry best;
+    if (store.getPersonalBest(key, playerName, best)) {
+        oss << "\nPersonal best " << formatTime(best.time) << ", "
+            << ordinal(store.getPlayerRank(key, playerName)) << " of " << groupDigits(store.getPlayerCount(key)) << " players";
+    }
+    if (!store.isSaving()) {
+        oss << "\nNot saved, the score log cannot be written";
+    }
+    setResult(oss.str());
+
+    // Open on the page that shows the new score, or the player's best in the personal best list
+    page = 0;
+    if (showBests) {
+        std::uint64_t playerRank = store.getPlayerRank(key, playerName);
+        if (playerRank > 0) page = (playerRank - 1) / SHOWN_ENTRIES;
+    } else {
+        std::vector<ScoreStore::Entry> kept = store.top(key, store.getKeptCount(key));
+        for (size_t i = 0; i < kept.size(); ++i) {
+            if (kept[i].sequence == newestSequence) page = i / SHOWN_ENTRIES;
         }
     }
-
-    // Save updated scores and reformat entries
-    saveToFile();
     formatEntries();
 }
@@ -1,26 +1,54 @@
 #ifndef LEADERBOARD_H
 #define LEADERBOARD_H
 
+#include "ScoreStore.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <string>
 
-class Leaderboard {
+// Best times of one board configuration, stored with every other board's in a shared score log.
+// The fastest runs are listed a page at a time; Tab switches to one line per player, ranked by
+// personal best. Only the visible page is ever turned into text no matter how many players there are.
+//
+// It is drawn as an overlay inside the game window. The text is rendered once into a texture
+// whenever the shown entries change, so drawing the overlay is a single sprite draw call.
+class Leaderboard : public sf::Drawable {
 public:
-    Leaderboard(const std::string& fontPath, const std::string& leaderboardFile);
-    void display(sf::RenderWindow& parentWindow); // Display the leaderboard
+    static const int WIDTH = 400;
+    static const int HEIGHT = 300;
+
+    Leaderboard(const std::string& fontPath, const std::string& scoreFile, int columns, int rows, int mines);
+    void setPosition(float x, float y) { sprite.setPosition(x, y); } // Top left corner of the overlay
+    void setVisible(bool show) { visible = show; }
+    bool isVisible() const { return visible; }
+    bool handleKey(sf::Keyboard::Key code); // Page through the list or switch lists, true if it changed
     void update(const std::string& playerName, int time); // Update leaderboard with a new score
+    int importFile(const std::string& file);      // Add "MM:SS,Name" lines for this board, returns how many
+    bool isEmpty() const { return store.isEmpty(); } // No scores for any board yet
 
 private:
+    static const int SHOWN_ENTRIES = 5; // Entries per page
+
     sf::Font font;
     sf::Text titleText;            // "LEADERBOARD"
-    std::vector<sf::Text> entries; // Leaderboard entries
-    std::string leaderboardFile;
-    std::vector<std::pair<int, std::string>> scores; // Pair of time and player name
+    std::vector<sf::Text> entries; // Leaderboard entries of the current page
+    sf::Text resultText;           // Placement of the last score and the player's personal best
+    sf::Text pageText;
+    ScoreStore store;
+    ScoreStore::Key key;           // The board this leaderboard shows
+    std::uint64_t newestSequence = UINT64_MAX; // Score added by the last update, marked with an asterisk
+    size_t page = 0;
+    bool showBests = false;        // Personal bests instead of the fastest runs
+    sf::RenderTexture texture;     // The formatted text, rendered once per change
+    sf::Sprite sprite;
+    bool visible = false;
 
-    void loadFromFile();      // Load leaderboard data from file
-    void saveToFile();        // Save updated leaderboard data to file
+    size_t getPageCount() const;
+    bool showPage(size_t newPage); // Clamped to the pages there are, true if the page changed
+    void setResult(const std::string& text); // Centered text below the entries
     void formatEntries();     // Format the text objects for display
+    void renderTexture();     // Draw the formatted text into the cached texture
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 };
 
 #endif // LEADERBOARD_H
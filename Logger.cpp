@@ -0,0 +1,143 @@
+#include "Logger.h"
+#include <cstdarg>
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots(new Slot[CAPACITY]), enqueuePos(0), dropped(0),
+      runtimeLevel(static_cast<int>(LogLevel::Info)), running(false), writers(0), idle(false) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() {
+    stop();
+}
+
+bool Logger::start(const std::string& file) {
+    if (running.load()) return true;
+
+    output = std::fopen(file.c_str(), "w");
+    if (!output) return false;
+
+    startTime = std::chrono::steady_clock::now();
+    running.store(true);
+    drainThread = std::thread(&Logger::drainLoop, this);
+    return true;
+}
+
+void Logger::stop() {
+    if (!running.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        idle.store(false);
+    }
+    wake.notify_one();
+    drainThread.join();
+
+    // A caller can have passed isEnabled() just before running went false, let it finish its slot
+    while (writers.load() > 0) {
+        std::this_thread::yield();
+    }
+    while (drainOnce()) {
+        // Flush whatever was queued while the thread was shutting down
+    }
+    if (dropped.load() > 0) {
+        std::fprintf(output, "%zu log messages dropped (ring buffer full)\n", dropped.load());
+    }
+    std::fclose(output);
+    output = nullptr;
+}
+
+void Logger::write(LogLevel level, const char* format, ...) {
+    // Registered before checking running, so stop() either sees this call or this call sees stop()
+    writers.fetch_add(1);
+    if (!running.load()) {
+        writers.fetch_sub(1);
+        return;
+    }
+
+    // Claim a slot (bounded multi-producer ring, one sequence number per slot)
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots[pos & (CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed); // Ring is full, never block the caller
+            writers.fetch_sub(1);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Format straight into the slot, no allocation
+    slot->level = level;
+    slot->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->text, MESSAGE_SIZE, format, args);
+    va_end(args);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // Wake the drain thread if it went to sleep on an empty ring. The fence pairs with the one in
+    // drainLoop(): either it sees this message before sleeping, or this call sees it idle.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            idle.store(false, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+    writers.fetch_sub(1);
+}
+
+bool Logger::drainOnce() {
+    if (!hasPending()) return false;
+    Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+
+    static const char* levelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+    std::fprintf(output, "[%10.3f] %-5s %s\n", slot.time, levelNames[static_cast<int>(slot.level)], slot.text);
+
+    // Hand the slot back to the producers for the next lap around the ring
+    slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+}
+
+bool Logger::hasPending() const {
+    return slots[dequeuePos & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+}
+
+void Logger::drainLoop() {
+    while (running.load(std::memory_order_relaxed)) {
+        bool wroteAny = false;
+        while (drainOnce()) {
+            wroteAny = true;
+        }
+        if (wroteAny) {
+            std::fflush(output);
+        }
+
+        // Nothing left, so sleep until a write (or stop) clears the idle flag
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (hasPending() || !running.load()) {
+            idle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        wake.wait(lock, [this] { return !idle.load(std::memory_order_relaxed); });
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class LogLevel { Trace = 0, Debug = 1, Info = 2, Warn = 3, Error = 4, Off = 5 };
+
+// Compile-time floor: calls below this level compile away entirely.
+// Release builds (NDEBUG) keep Info and above, override with -DMINESWEEPER_LOG_LEVEL=<0-5>.
+#ifndef MINESWEEPER_LOG_LEVEL
+#ifdef NDEBUG
+#define MINESWEEPER_LOG_LEVEL 2
+#else
+#define MINESWEEPER_LOG_LEVEL 0
+#endif
+#endif
+
+// Asynchronous logger. Callers format into a slot of a lock-free ring buffer and return;
+// a background thread drains the ring to a file. A full ring drops the message instead
+// of blocking the caller. While the ring is empty the drain thread sleeps on a condition
+// variable, and only a write that finds it asleep takes the lock to wake it.
+class Logger {
+public:
+    static Logger& instance();
+
+    bool start(const std::string& file); // Open the log file and start the drain thread
+    void stop();                         // Drain what is left and join the thread
+
+    void setLevel(LogLevel level) { runtimeLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(runtimeLevel.load(std::memory_order_relaxed)); }
+    bool isEnabled(LogLevel level) const {
+        return running.load(std::memory_order_relaxed) &&
+               static_cast<int>(level) >= runtimeLevel.load(std::memory_order_relaxed);
+    }
+
+    void write(LogLevel level, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    size_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    ~Logger();
+
+private:
+    static const size_t CAPACITY = 4096;     // Ring slots, must be a power of two
+    static const size_t MESSAGE_SIZE = 240;  // Longer messages are truncated
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Logger ring capacity must be a power of two");
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        double time; // Seconds since start()
+        char text[MESSAGE_SIZE];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePos;
+    size_t dequeuePos = 0; // Only touched by the drain thread
+    std::atomic<size_t> dropped;
+    std::atomic<int> runtimeLevel;
+    std::atomic<bool> running;
+    std::atomic<int> writers;  // Calls inside write(), stop() waits for them before the last drain
+    std::atomic<bool> idle;    // The drain thread is waiting, or about to wait, for a write
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::thread drainThread;
+    std::FILE* output = nullptr;
+    std::chrono::steady_clock::time_point startTime;
+
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    bool drainOnce(); // Write one message, false if the ring was empty
+    bool hasPending() const; // The next message is ready to be written
+    void drainLoop();
+};
+
+#define MINESWEEPER_LOG(level, ...)                                                   \
+    do {                                                                              \
+        if (static_cast<int>(level) >= MINESWEEPER_LOG_LEVEL &&                       \
+            Logger::instance().isEnabled(level)) {                                    \
+            Logger::instance().write(level, __VA_ARGS__);                             \
+        }                                                                             \
+    } while (0)
+
+#define LOG_TRACE(...) MINESWEEPER_LOG(LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) MINESWEEPER_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) MINESWEEPER_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...) MINESWEEPER_LOG(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) MINESWEEPER_LOG(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,58 @@
+#include "MappedFile.h"
+#include <cstdio>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string& file) {
+    close();
+
+#ifndef _WIN32
+    int descriptor = ::open(file.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+    if (info.st_size > 0) {
+        void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            ::close(descriptor);
+            return false;
+        }
+        bytes = static_cast<const std::uint8_t*>(address);
+        length = info.st_size;
+        mapped = true;
+    }
+    ::close(descriptor); // The mapping keeps the file alive
+#else
+    std::FILE* input = std::fopen(file.c_str(), "rb");
+    if (!input) return false;
+    std::uint8_t chunk[65536];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + read);
+    }
+    std::fclose(input);
+    bytes = buffer.data();
+    length = buffer.size();
+#endif
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) munmap(const_cast<std::uint8_t*>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+    mapped = false;
+    buffer.clear();
+}
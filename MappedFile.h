@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file, memory-mapped where the platform allows it and read into a
+// buffer otherwise. The data stays valid until close() or destruction.
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& file); // False if the file cannot be opened
+    void close();
+    bool isOpen() const { return opened; }
+
+    const std::uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const std::uint8_t* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+    bool mapped = false;
+    std::vector<std::uint8_t> buffer; // Used instead of a mapping where mmap is not available
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif // MAPPED_FILE_H
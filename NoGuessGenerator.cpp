@@ -0,0 +1,66 @@
+#include "NoGuessGenerator.h"
+#include "GameEngine.h"
+#include "Logger.h"
+#include "Random.h"
+#include "Solver.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Plays a candidate to the end with the solver, reusing the worker's engine and solver
+static bool checkCandidate(GameEngine& engine, Solver& solver, int row, int col, std::uint64_t seed) {
+    engine.reset(seed);
+    engine.reveal(row, col);
+    return solveWithoutGuessing(engine, solver);
+}
+
+bool isNoGuessBoard(int columns, int rows, int mines, int row, int col, std::uint64_t seed) {
+    GameEngine engine(columns, rows, mines, seed, GameEngine::Generation::SafeFirstClick);
+    Solver solver;
+    return checkCandidate(engine, solver, row, col, seed);
+}
+
+bool findNoGuessSeed(int columns, int rows, int mines, int row, int col, std::uint64_t seed,
+                     std::uint64_t& result, int maxCandidates, unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::atomic<int> nextCandidate(0);
+    std::atomic<int> best(maxCandidates); // Lowest solvable candidate found so far
+
+    auto work = [&] {
+        GameEngine engine(columns, rows, mines, seed, GameEngine::Generation::SafeFirstClick);
+        Solver solver;
+        for (;;) {
+            // Candidates above the best one found can no longer win, stop taking new ones
+            int index = nextCandidate.fetch_add(1, std::memory_order_relaxed);
+            if (index >= best.load(std::memory_order_relaxed)) break;
+
+            if (checkCandidate(engine, solver, row, col, Random::streamSeed(seed, index))) {
+                int current = best.load(std::memory_order_relaxed);
+                while (index < current && !best.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+                }
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work(); // The calling thread works too
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    int found = best.load();
+    LOG_DEBUG("No-guess search: %d candidates checked, %s", std::min(nextCandidate.load(), maxCandidates),
+              found < maxCandidates ? "solvable board found" : "none solvable");
+    if (found >= maxCandidates) return false;
+
+    result = Random::streamSeed(seed, found);
+    return true;
+}
@@ -0,0 +1,18 @@
+#ifndef NO_GUESS_GENERATOR_H
+#define NO_GUESS_GENERATOR_H
+
+#include <cstdint>
+
+// Searches for a board that the logic solver can finish from a safe first click at (row, col).
+// Candidate seeds are the SplitMix64 stream starting at `seed`. They are checked on all cores,
+// but the lowest solvable candidate always wins, so the result does not depend on timing or
+// thread count. On success `result` is the seed that reproduces the board with
+// GameEngine::Generation::SafeFirstClick; returns false if none of `maxCandidates` was solvable.
+const int NO_GUESS_CANDIDATES = 100000; // Default number of candidates tried
+bool findNoGuessSeed(int columns, int rows, int mines, int row, int col, std::uint64_t seed,
+                     std::uint64_t& result, int maxCandidates = NO_GUESS_CANDIDATES, unsigned threads = 0);
+
+// Checks a single candidate
+bool isNoGuessBoard(int columns, int rows, int mines, int row, int col, std::uint64_t seed);
+
+#endif // NO_GUESS_GENERATOR_H
@@ -0,0 +1,388 @@
+#include "ProbabilityEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+// One group of frontier cells linked by shared numbers
+struct Component {
+    std::vector<int> cells;  // Board indices, in enumeration order
+    std::vector<int> needed; // Per number: mines needed among its hidden cells
+    // Per cell position: the numbers it belongs to, and how many of that number's cells come later
+    std::vector<std::vector<std::pair<int, int>>> steps;
+    std::string key;
+};
+
+// Enumeration state per cell position: the mines each number still needs, one byte per number
+struct Layer {
+    std::unordered_map<std::string, std::vector<double>> states; // Counts by mines placed so far (or still to place)
+    double logScale = 0.0;                                       // Stored counts are the real ones / exp(logScale)
+};
+
+// target += source shifted by `shift` mines
+void accumulate(std::vector<double>& target, const std::vector<double>& source, int shift) {
+    if (target.size() < source.size() + shift) target.resize(source.size() + shift, 0.0);
+    for (size_t k = 0; k < source.size(); ++k) {
+        target[k + shift] += source[k];
+    }
+}
+
+// Rescales a layer so its largest count is 1, keeping huge components within double range
+void normalize(Layer& layer, double logScale) {
+    double largest = 0.0;
+    for (const auto& entry : layer.states) {
+        for (double count : entry.second) largest = std::max(largest, count);
+    }
+    layer.logScale = logScale;
+    if (largest <= 0.0) return;
+    for (auto& entry : layer.states) {
+        for (double& count : entry.second) count /= largest;
+    }
+    layer.logScale += std::log(largest);
+}
+
+// Assigns `value` to the cell at `position`, false if a number can no longer be satisfied
+bool step(const Component& component, const std::string& state, int position, int value, std::string& next) {
+    next = state;
+    for (const auto& number : component.steps[position]) {
+        int left = next[number.first] - value;
+        if (left < 0 || left > number.second) return false;
+        next[number.first] = static_cast<char>(left);
+    }
+    return true;
+}
+
+std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b, size_t limit) {
+    std::vector<double> result(std::min(a.size() + b.size() - 1, limit), 0.0);
+    for (size_t i = 0; i < a.size() && i < limit; ++i) {
+        for (size_t j = 0; j < b.size() && i + j < limit; ++j) {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    double largest = result.empty() ? 0.0 : *std::max_element(result.begin(), result.end());
+    if (largest > 0.0) {
+        for (double& value : result) value /= largest;
+    }
+    return result;
+}
+
+ProbabilityEngine::ComponentResult enumerate(const Component& component) {
+    const int n = static_cast<int>(component.cells.size());
+    std::string initial(component.needed.size(), 0);
+    for (size_t i = 0; i < component.needed.size(); ++i) {
+        initial[i] = static_cast<char>(component.needed[i]);
+    }
+
+    // Forward: counts of the ways to reach each state, by mines placed so far
+    std::vector<Layer> forward(n + 1);
+    forward[0].states[initial] = std::vector<double>(1, 1.0);
+    std::string next;
+    for (int d = 0; d < n; ++d) {
+        for (const auto& entry : forward[d].states) {
+            for (int value = 0; value <= 1; ++value) {
+                if (step(component, entry.first, d, value, next)) {
+                    accumulate(forward[d + 1].states[next], entry.second, value);
+                }
+            }
+        }
+        normalize(forward[d + 1], forward[d].logScale);
+    }
+
+    // Backward: from each state, the ways to finish, by mines still to place (the memoized search)
+    std::vector<Layer> backward(n + 1);
+    for (const auto& entry : forward[n].states) {
+        backward[n].states[entry.first] = std::vector<double>(1, 1.0); // Every number is satisfied here
+    }
+    for (int d = n - 1; d >= 0; --d) {
+        for (const auto& entry : forward[d].states) {
+            std::vector<double> counts;
+            for (int value = 0; value <= 1; ++value) {
+                if (!step(component, entry.first, d, value, next)) continue;
+                auto found = backward[d + 1].states.find(next);
+                if (found != backward[d + 1].states.end()) accumulate(counts, found->second, value);
+            }
+            if (!counts.empty()) backward[d].states[entry.first].swap(counts);
+        }
+        normalize(backward[d], backward[d + 1].logScale);
+    }
+
+    ProbabilityEngine::ComponentResult result;
+    auto start = backward[0].states.find(initial);
+    if (start == backward[0].states.end()) return result; // No valid layout
+
+    result.configurations = start->second;
+    double largest = *std::max_element(result.configurations.begin(), result.configurations.end());
+    for (double& count : result.configurations) count /= largest;
+
+    // A cell is a mine in (ways to reach its layer) x (ways to finish after placing a mine there)
+    result.cellMines.resize(n);
+    for (int d = 0; d < n; ++d) {
+        std::vector<double>& mines = result.cellMines[d];
+        mines.assign(result.configurations.size(), 0.0);
+        double scale = std::exp(forward[d].logScale + backward[d + 1].logScale - backward[0].logScale) / largest;
+
+        for (const auto& entry : forward[d].states) {
+            if (!step(component, entry.first, d, 1, next)) continue;
+            auto found = backward[d + 1].states.find(next);
+            if (found == backward[d + 1].states.end()) continue;
+
+            const std::vector<double>& before = entry.second;
+            const std::vector<double>& after = found->second;
+            for (size_t i = 0; i < before.size(); ++i) {
+                for (size_t j = 0; j < after.size() && i + j + 1 < mines.size(); ++j) {
+                    mines[i + j + 1] += before[i] * after[j] * scale;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int findRoot(std::vector<int>& parent, int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+void appendInt(std::string& key, int value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+bool ProbabilityEngine::compute(const GameEngine& engine) {
+    const Board& board = engine.getBoard();
+    const int columns = board.getColumns();
+    const int rows = board.getRows();
+
+    probabilities.assign(board.size(), 0.0f);
+    safestCell = -1;
+    interiorProbability = 0.0f;
+    componentCount = 0;
+    cacheHits = 0;
+
+    // Revealed numbers that still touch hidden cells, with the frontier cells joined by a union-find
+    struct Number {
+        int needed;
+        std::vector<int> cells;
+    };
+    std::vector<Number> numbers;
+    std::vector<int> numberOf(board.size(), -1);
+    std::vector<int> parent(board.size(), -1); // -1 for cells off the frontier
+    int unknownCount = 0;
+    int frontierCount = 0;
+
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (cell.isRevealed()) {
+            if (cell.isMine()) return false; // Lost game, nothing to estimate
+            continue;
+        }
+        if (cell.isFlagged()) {
+            probabilities[index] = 1.0f;
+        } else {
+            ++unknownCount;
+        }
+    }
+
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (!cell.isRevealed()) continue;
+
+        Number number;
+        number.needed = cell.adjacentMines();
+        int row = index / columns, col = index % columns;
+        for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); ++r) {
+            for (int c = std::max(col - 1, 0); c <= std::min(col + 1, columns - 1); ++c) {
+                Cell neighbor = board[r * columns + c];
+                if (neighbor.isRevealed()) continue;
+                if (neighbor.isFlagged()) {
+                    --number.needed;
+                } else {
+                    number.cells.push_back(r * columns + c);
+                }
+            }
+        }
+        if (number.needed < 0 || number.needed > static_cast<int>(number.cells.size())) return false;
+        if (number.cells.empty()) continue;
+
+        for (int neighbor : number.cells) {
+            if (parent[neighbor] < 0) {
+                parent[neighbor] = neighbor;
+                ++frontierCount;
+            }
+            parent[findRoot(parent, neighbor)] = findRoot(parent, number.cells.front());
+        }
+        numberOf[index] = static_cast<int>(numbers.size());
+        numbers.push_back(number);
+    }
+
+    // Group the numbers by component
+    std::vector<int> componentOf(board.size(), -1); // By root cell
+    std::vector<std::vector<int>> componentNumbers;
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        int root = findRoot(parent, numbers[i].cells.front());
+        if (componentOf[root] < 0) {
+            componentOf[root] = static_cast<int>(componentNumbers.size());
+            componentNumbers.push_back(std::vector<int>());
+        }
+        componentNumbers[componentOf[root]].push_back(static_cast<int>(i));
+    }
+    componentCount = static_cast<int>(componentNumbers.size());
+
+    // Order each component's cells breadth first through its numbers, so only a few numbers are
+    // partly assigned at any point and the enumeration states stay few
+    std::vector<Component> components(componentCount);
+    std::vector<int> position(board.size(), -1);
+    std::vector<int> localNumber(numbers.size(), -1);
+    for (int i = 0; i < componentCount; ++i) {
+        Component& component = components[i];
+        std::vector<int> queue(1, componentNumbers[i].front());
+        localNumber[queue.front()] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (int cell : numbers[queue[head]].cells) {
+                if (position[cell] >= 0) continue;
+                position[cell] = static_cast<int>(component.cells.size());
+                component.cells.push_back(cell);
+
+                int row = cell / columns, col = cell % columns;
+                for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); ++r) {
+                    for (int c = std::max(col - 1, 0); c <= std::min(col + 1, columns - 1); ++c) {
+                        int other = numberOf[r * columns + c];
+                        if (other < 0 || localNumber[other] >= 0) continue;
+                        localNumber[other] = static_cast<int>(queue.size());
+                        queue.push_back(other);
+                    }
+                }
+            }
+        }
+
+        component.steps.resize(component.cells.size());
+        for (int cell : component.cells) appendInt(component.key, cell);
+        for (int number : queue) {
+            std::vector<int> positions;
+            for (int cell : numbers[number].cells) positions.push_back(position[cell]);
+            std::sort(positions.begin(), positions.end());
+            for (size_t j = 0; j < positions.size(); ++j) {
+                component.steps[positions[j]].push_back(std::make_pair(localNumber[number], static_cast<int>(positions.size() - 1 - j)));
+            }
+            component.needed.push_back(numbers[number].needed);
+
+            appendInt(component.key, numbers[number].needed);
+            appendInt(component.key, static_cast<int>(positions.size()));
+            for (int p : positions) appendInt(component.key, p);
+        }
+    }
+
+    // Reuse unchanged components, count the rest in parallel
+    std::vector<std::shared_ptr<const ComponentResult>> results(componentCount);
+    std::vector<int> misses;
+    for (int i = 0; i < componentCount; ++i) {
+        auto found = cache.find(components[i].key);
+        if (found != cache.end()) {
+            results[i] = found->second;
+            ++cacheHits;
+        } else {
+            misses.push_back(i);
+        }
+    }
+
+    std::atomic<size_t> nextMiss(0);
+    auto work = [&] {
+        for (size_t m = nextMiss.fetch_add(1); m < misses.size(); m = nextMiss.fetch_add(1)) {
+            results[misses[m]] = std::make_shared<ComponentResult>(enumerate(components[misses[m]]));
+        }
+    };
+    unsigned threads = std::min<unsigned>(std::max(std::thread::hardware_concurrency(), 1u), misses.size());
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<const ComponentResult>> used;
+    for (int i = 0; i < componentCount; ++i) {
+        if (results[i]->configurations.empty()) return false;
+        used[components[i].key] = results[i];
+    }
+    cache.swap(used); // Drop components that no longer exist
+
+    // Ways to place the remaining mines in the interior, by the number of mines on the frontier
+    const int remaining = engine.getRemainingMines();
+    const int interior = unknownCount - frontierCount;
+    if (remaining < 0) return false;
+
+    std::vector<double> weight(remaining + 1, 0.0);
+    double largestLog = -HUGE_VAL;
+    std::vector<double> logWeight(remaining + 1, -HUGE_VAL);
+    for (int k = 0; k <= remaining; ++k) {
+        int inside = remaining - k;
+        if (inside > interior) continue;
+        logWeight[k] = std::lgamma(interior + 1.0) - std::lgamma(inside + 1.0) - std::lgamma(interior - inside + 1.0);
+        largestLog = std::max(largestLog, logWeight[k]);
+    }
+    for (int k = 0; k <= remaining; ++k) {
+        if (logWeight[k] > -HUGE_VAL) weight[k] = std::exp(logWeight[k] - largestLog);
+    }
+
+    // Mine count distributions of all components before and after each one
+    const size_t limit = remaining + 1;
+    std::vector<std::vector<double>> prefix(componentCount + 1, std::vector<double>(1, 1.0));
+    std::vector<std::vector<double>> suffix(componentCount + 1, std::vector<double>(1, 1.0));
+    for (int i = 0; i < componentCount; ++i) {
+        prefix[i + 1] = convolve(prefix[i], results[i]->configurations, limit);
+    }
+    for (int i = componentCount - 1; i >= 0; --i) {
+        suffix[i] = convolve(results[i]->configurations, suffix[i + 1], limit);
+    }
+
+    for (int i = 0; i < componentCount; ++i) {
+        const ComponentResult& result = *results[i];
+        std::vector<double> others = convolve(prefix[i], suffix[i + 1], limit);
+
+        // Weight of k mines in this component, summed over everything else
+        std::vector<double> combined(result.configurations.size(), 0.0);
+        double total = 0.0;
+        for (size_t k = 0; k < combined.size(); ++k) {
+            for (size_t j = 0; j < others.size() && k + j < limit; ++j) {
+                combined[k] += others[j] * weight[k + j];
+            }
+            total += result.configurations[k] * combined[k];
+        }
+        if (total <= 0.0) return false;
+
+        for (size_t p = 0; p < components[i].cells.size(); ++p) {
+            double mines = 0.0;
+            for (size_t k = 0; k < combined.size(); ++k) {
+                mines += result.cellMines[p][k] * combined[k];
+            }
+            probabilities[components[i].cells[p]] = static_cast<float>(std::min(mines / total, 1.0));
+        }
+    }
+
+    // Every interior cell has the same chance: expected interior mines / interior cells
+    const std::vector<double>& all = prefix[componentCount];
+    double total = 0.0, interiorMines = 0.0;
+    for (size_t k = 0; k < all.size(); ++k) {
+        total += all[k] * weight[k];
+        interiorMines += all[k] * weight[k] * (remaining - static_cast<int>(k));
+    }
+    if (total <= 0.0) return false;
+    if (interior > 0) interiorProbability = static_cast<float>(interiorMines / total / interior);
+
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (cell.isRevealed() || cell.isFlagged()) continue;
+        if (parent[index] < 0) probabilities[index] = interiorProbability;
+        if (safestCell < 0 || probabilities[index] < probabilities[safestCell]) safestCell = index;
+    }
+    return true;
+}
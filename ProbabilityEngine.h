@@ -0,0 +1,49 @@
+#ifndef PROBABILITY_ENGINE_H
+#define PROBABILITY_ENGINE_H
+
+#include "GameEngine.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Exact mine probabilities for every hidden cell, from the visible state only (revealed numbers
+// and flags, trusted to be on mines).
+//
+// The frontier (hidden cells next to a revealed number) is split into components that share no
+// number, and each component's valid layouts are counted per mine count with a layered DP over
+// its cells (memoized backtracking: layouts that leave the same numbers unsatisfied are merged).
+// Components are combined with the number of ways to place the remaining mines among the interior
+// cells. Component results are cached by their contents, so a move only recounts the components it
+// touched, and components that do need counting run on separate threads.
+class ProbabilityEngine {
+public:
+    // Returns false if no mine layout agrees with the visible state (a wrong flag)
+    bool compute(const GameEngine& engine);
+
+    float getProbability(int index) const { return probabilities[index]; } // 0 if revealed, 1 if flagged
+    const std::vector<float>& getProbabilities() const { return probabilities; }
+    int getSafestCell() const { return safestCell; }                        // -1 if no hidden cell is left
+    float getInteriorProbability() const { return interiorProbability; }    // Any cell away from the frontier
+
+    int getComponentCount() const { return componentCount; }
+    int getCacheHits() const { return cacheHits; } // Components reused from the previous compute()
+
+    // Layout counts of one component, scaled so that the largest configuration count is 1
+    struct ComponentResult {
+        std::vector<double> configurations;         // [k] layouts with k mines in the component
+        std::vector<std::vector<double>> cellMines; // [cell][k] of those, layouts where the cell is a mine
+    };
+
+private:
+    std::vector<float> probabilities;
+    int safestCell = -1;
+    float interiorProbability = 0.0f;
+    int componentCount = 0;
+    int cacheHits = 0;
+
+    // Keyed by the component's cells and numbers, which fully determine the result
+    std::unordered_map<std::string, std::shared_ptr<const ComponentResult>> cache;
+};
+
+#endif // PROBABILITY_ENGINE_H
@@ -0,0 +1,12 @@
+#include "Random.h"
+#include <chrono>
+#include <random>
+
+std::uint64_t Random::entropySeed() {
+    std::random_device device;
+    std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+
+    // Mix in the clock in case random_device is deterministic on this platform
+    seed ^= static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return splitMix(seed);
+}
@@ -0,0 +1,69 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Small, fast PRNG (xoshiro256**) with an explicit 64-bit seed, so the same seed
+// gives the same sequence on every platform and standard library.
+class Random {
+public:
+    explicit Random(std::uint64_t seed) {
+        // Expand the seed into the 256-bit state with SplitMix64, as the xoshiro authors recommend
+        for (int i = 0; i < 4; ++i) {
+            state[i] = splitMix(seed);
+        }
+    }
+
+    std::uint64_t next() {
+        std::uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+        std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotateLeft(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound), without modulo bias (Lemire's multiply-and-reject)
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t product = (next() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // Uniform double in [0, 1)
+    double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // SplitMix64 step, also useful to derive independent seeds from one seed
+    static std::uint64_t splitMix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Seed number `index` of the SplitMix64 stream starting at `seed`, computed directly so
+    // independent streams (candidate boards, simulated games) can be handed out in any order
+    static std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t index) {
+        std::uint64_t state = seed + index * 0x9E3779B97F4A7C15ULL;
+        return splitMix(state);
+    }
+
+    static std::uint64_t entropySeed(); // Seed from std::random_device and the clock
+
+private:
+    std::uint64_t state[4];
+
+    static std::uint64_t rotateLeft(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,226 @@
+#include "Replay.h"
+#include <cstdio>
+
+static const std::uint8_t MAGIC[3] = {'M', 'S', 'R'};
+static const std::uint8_t VERSION = 2;
+static const std::uint8_t UNBATCHED_VERSION = 1; // Before batches were recorded, still read
+
+static void writeVarint(std::vector<std::uint8_t>& output, std::uint64_t value) {
+    while (value >= 0x80) {
+        output.push_back(static_cast<std::uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    output.push_back(static_cast<std::uint8_t>(value));
+}
+
+static bool readVarint(const std::uint8_t* data, size_t size, size_t& position, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position < size; shift += 7) {
+        std::uint8_t byte = data[position++];
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false; // Truncated or longer than 64 bits
+}
+
+static void writeFixed64(std::vector<std::uint8_t>& output, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        output.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+    }
+}
+
+static bool readFixed64(const std::uint8_t* data, size_t size, size_t& position, std::uint64_t& value) {
+    if (size - position < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(data[position++]) << (i * 8);
+    }
+    return true;
+}
+
+// Maps signed deltas to unsigned so small negative steps stay short as varints
+static std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+void Replay::begin(const GameEngine& engine) {
+    columns = engine.getColumns();
+    rows = engine.getRows();
+    mines = engine.getMines();
+    seed = engine.getSeed(); // Before the first reveal, NoGuess replaces it with the accepted candidate
+    generation = engine.getGeneration();
+    events.clear();
+    finalState = GameEngine::State::Playing;
+    finalHash = 0;
+}
+
+void Replay::record(std::uint32_t time, const GameEngine::Action* actions, size_t count) {
+    // Game time never runs backwards within a recording
+    if (!events.empty() && time < events.back().time) time = events.back().time;
+
+    // Actions off the board do nothing in the engine either, so they are left out
+    bool batched = false;
+    for (size_t i = 0; i < count; ++i) {
+        const GameEngine::Action& action = actions[i];
+        if (action.row < 0 || action.row >= rows || action.col < 0 || action.col >= columns) continue;
+        Event event = {time, action.type, action.row * columns + action.col, batched};
+        events.push_back(event);
+        batched = true;
+    }
+}
+
+void Replay::finish(const GameEngine& engine) {
+    finalState = engine.getState();
+    finalHash = boardHash(engine.getBoard());
+}
+
+void Replay::encode(std::vector<std::uint8_t>& output) const {
+    output.insert(output.end(), MAGIC, MAGIC + 3);
+    output.push_back(VERSION);
+    writeVarint(output, columns);
+    writeVarint(output, rows);
+    writeVarint(output, mines);
+    output.push_back(static_cast<std::uint8_t>(generation));
+    writeFixed64(output, seed);
+
+    writeVarint(output, events.size());
+    std::uint32_t previousTime = 0;
+    int previousCell = 0;
+    for (const Event& event : events) {
+        writeVarint(output, event.time - previousTime);
+        writeVarint(output, zigzag(static_cast<std::int64_t>(event.cell) - previousCell) << 3 |
+                                static_cast<std::uint64_t>(event.batched) << 2 | static_cast<std::uint64_t>(event.type));
+        previousTime = event.time;
+        previousCell = event.cell;
+    }
+
+    output.push_back(static_cast<std::uint8_t>(finalState));
+    writeFixed64(output, finalHash);
+}
+
+bool Replay::decode(const std::uint8_t* data, size_t size, size_t& position) {
+    size_t at = position;
+    if (size - at < 4 || data[at] != MAGIC[0] || data[at + 1] != MAGIC[1] || data[at + 2] != MAGIC[2] ||
+        (data[at + 3] != VERSION && data[at + 3] != UNBATCHED_VERSION)) {
+        return false;
+    }
+    bool hasBatches = data[at + 3] != UNBATCHED_VERSION;
+    at += 4;
+
+    std::uint64_t width, height, mineCount, count;
+    if (!readVarint(data, size, at, width) || !readVarint(data, size, at, height) ||
+        !readVarint(data, size, at, mineCount) || at >= size) {
+        return false;
+    }
+    std::uint8_t generationByte = data[at++];
+    std::uint64_t boardSeed;
+    if (!readFixed64(data, size, at, boardSeed) || !readVarint(data, size, at, count)) return false;
+
+    // Reject sizes no game could have, so a corrupt record cannot ask for a huge allocation
+    std::uint64_t cells = width * height;
+    if (width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF || cells > 0x7FFFFFFF ||
+        mineCount > cells || generationByte > static_cast<std::uint8_t>(GameEngine::Generation::NoGuess) ||
+        count > size - at) {
+        return false;
+    }
+
+    std::vector<Event> decoded;
+    decoded.reserve(count);
+    std::uint64_t time = 0;
+    std::int64_t cell = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t timeDelta, packed;
+        if (!readVarint(data, size, at, timeDelta) || !readVarint(data, size, at, packed)) return false;
+
+        time += timeDelta;
+        std::uint64_t type = packed & 3;
+        bool batched = hasBatches && (packed & 4) != 0;
+        cell += unzigzag(packed >> (hasBatches ? 3 : 2));
+        if (time > 0xFFFFFFFFu || cell < 0 || static_cast<std::uint64_t>(cell) >= cells ||
+            type > static_cast<std::uint64_t>(GameEngine::ActionType::Chord) || (batched && i == 0)) {
+            return false;
+        }
+        Event event = {static_cast<std::uint32_t>(time), static_cast<GameEngine::ActionType>(type),
+                       static_cast<int>(cell), batched};
+        decoded.push_back(event);
+    }
+
+    std::uint64_t hash;
+    if (at >= size || data[at] > static_cast<std::uint8_t>(GameEngine::State::Lost)) return false;
+    std::uint8_t stateByte = data[at++];
+    if (!readFixed64(data, size, at, hash)) return false;
+
+    columns = static_cast<int>(width);
+    rows = static_cast<int>(height);
+    mines = static_cast<int>(mineCount);
+    seed = boardSeed;
+    generation = static_cast<GameEngine::Generation>(generationByte);
+    events.swap(decoded);
+    finalState = static_cast<GameEngine::State>(stateByte);
+    finalHash = hash;
+    position = at;
+    return true;
+}
+
+bool Replay::append(const std::string& file) const {
+    std::vector<std::uint8_t> buffer;
+    encode(buffer);
+
+    std::FILE* output = std::fopen(file.c_str(), "ab");
+    if (!output) return false;
+    bool written = std::fwrite(buffer.data(), 1, buffer.size(), output) == buffer.size();
+    return std::fclose(output) == 0 && written;
+}
+
+bool Replay::load(const std::string& file, std::vector<Replay>& replays) {
+    std::FILE* input = std::fopen(file.c_str(), "rb");
+    if (!input) return false;
+
+    std::vector<std::uint8_t> buffer;
+    std::uint8_t chunk[65536];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + read);
+    }
+    std::fclose(input);
+
+    size_t position = 0;
+    while (position < buffer.size()) {
+        Replay replay;
+        if (!replay.decode(buffer.data(), buffer.size(), position)) return false;
+        replays.push_back(std::move(replay));
+    }
+    return true;
+}
+
+bool Replay::verify() const {
+    GameEngine engine(columns, rows, mines, seed, generation);
+    std::vector<GameEngine::Action> batch;
+    for (size_t i = 0; i < events.size();) {
+        if (engine.isOver()) return false; // The recording goes on after the game ended
+
+        // Each batch goes to the engine the way it was played, with win/loss decided at its end
+        batch.clear();
+        do {
+            GameEngine::Action action = {events[i].type, events[i].cell / columns, events[i].cell % columns};
+            batch.push_back(action);
+            ++i;
+        } while (i < events.size() && events[i].batched);
+        engine.apply(batch);
+    }
+    return engine.getState() == finalState && boardHash(engine.getBoard()) == finalHash;
+}
+
+std::uint64_t Replay::boardHash(const Board& board) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    const Cell* cells = board.data();
+    for (int i = 0; i < board.size(); ++i) {
+        hash ^= cells[i].bits;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
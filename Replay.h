@@ -0,0 +1,76 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "GameEngine.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Recording of one game: the board parameters and seed, every action with the game time it
+// was made at, and the final state so a playback can be checked against it.
+//
+// Binary layout of one record (all varints are LEB128, little-endian 7 bits per byte):
+//   "MSR" version(1)  columns rows mines (varints)  generation(1)  seed(8)
+//   event count (varint), then per event:
+//     time delta in milliseconds (varint)
+//     zigzag(cell - previous cell) << 3 | batched << 2 | action type (varint)
+//   final state(1)  board hash(8)
+// Clicks are usually close to the previous one and batches share a timestamp, so most events
+// take two or three bytes. Records can be appended to one file back to back. Version 1 records,
+// which had no batched bit (zigzag << 2 | type), are still read, with one action per batch.
+//
+// The engine decides win or loss once per batch, so a batch is replayed as one batch: playing
+// an auto-play round action by action would end the game before its last no-op moves.
+class Replay {
+public:
+    struct Event {
+        std::uint32_t time; // Milliseconds of game time, pauses excluded
+        GameEngine::ActionType type;
+        int cell;
+        bool batched; // Applied in the same GameEngine::apply() call as the previous event
+    };
+
+    // Start a recording of the game the engine was just reset to
+    void begin(const GameEngine& engine);
+    // Records one batch of actions, as it was passed to GameEngine::apply()
+    void record(std::uint32_t time, const GameEngine::Action* actions, size_t count);
+    void record(std::uint32_t time, const std::vector<GameEngine::Action>& actions) {
+        record(time, actions.data(), actions.size());
+    }
+    void finish(const GameEngine& engine); // Store the final state and board hash
+
+    int getColumns() const { return columns; }
+    int getRows() const { return rows; }
+    int getMines() const { return mines; }
+    std::uint64_t getSeed() const { return seed; }
+    GameEngine::Generation getGeneration() const { return generation; }
+    const std::vector<Event>& getEvents() const { return events; }
+    std::uint32_t getDuration() const { return events.empty() ? 0 : events.back().time; }
+    GameEngine::State getFinalState() const { return finalState; }
+    std::uint64_t getFinalHash() const { return finalHash; }
+
+    void encode(std::vector<std::uint8_t>& output) const; // Appends one record
+    // Decodes one record starting at `position` and moves past it, false if it is malformed
+    bool decode(const std::uint8_t* data, size_t size, size_t& position);
+
+    bool append(const std::string& file) const; // Adds this record at the end of the file
+    static bool load(const std::string& file, std::vector<Replay>& replays);
+
+    // Plays the recorded batches on a fresh engine at full speed. Returns true if the game ends
+    // in the recorded state with the recorded board hash.
+    bool verify() const;
+
+    static std::uint64_t boardHash(const Board& board); // FNV-1a over the cell bytes
+
+private:
+    int columns = 0;
+    int rows = 0;
+    int mines = 0;
+    std::uint64_t seed = 0;
+    GameEngine::Generation generation = GameEngine::Generation::Random;
+    std::vector<Event> events;
+    GameEngine::State finalState = GameEngine::State::Playing;
+    std::uint64_t finalHash = 0;
+};
+
+#endif // REPLAY_H
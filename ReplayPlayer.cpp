@@ -0,0 +1,75 @@
+// Headless replay player: plays every recorded game in the given files at full speed and
+// checks that each one ends in the recorded state. Exits with an error if any replay does
+// not match, so it can guard engine changes and back up disputed leaderboard times.
+#include "Replay.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+static const char* stateName(GameEngine::State state) {
+    switch (state) {
+        case GameEngine::State::Won: return "won";
+        case GameEngine::State::Lost: return "lost";
+        default: return "unfinished";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    vector<string> files;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (option == "--verbose") {
+            verbose = true; // One line per replay
+        } else if (option == "--help" || option.compare(0, 2, "--") == 0) {
+            fprintf(stderr, "Usage: %s [--verbose] replays.msr...\n", argv[0]);
+            return option == "--help" ? 0 : 1;
+        } else {
+            files.push_back(option);
+        }
+    }
+    if (files.empty()) {
+        fprintf(stderr, "Usage: %s [--verbose] replays.msr...\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t replayCount = 0, eventCount = 0, failed = 0;
+    double seconds = 0.0;
+    for (const string& file : files) {
+        vector<Replay> replays;
+        if (!Replay::load(file, replays)) {
+            fprintf(stderr, "%s: unreadable or corrupt after %zu replays\n", file.c_str(), replays.size());
+            ++failed;
+        }
+
+        for (size_t i = 0; i < replays.size(); ++i) {
+            const Replay& replay = replays[i];
+            Clock::time_point start = Clock::now();
+            bool valid = replay.verify();
+            seconds += chrono::duration<double>(Clock::now() - start).count();
+
+            ++replayCount;
+            eventCount += replay.getEvents().size();
+            if (!valid) ++failed;
+            if (!valid || verbose) {
+                printf("%s #%zu: %dx%d, %d mines, seed %llu, %zu actions, %s in %.3fs%s\n", file.c_str(), i,
+                       replay.getColumns(), replay.getRows(), replay.getMines(),
+                       static_cast<unsigned long long>(replay.getSeed()), replay.getEvents().size(),
+                       stateName(replay.getFinalState()), replay.getDuration() / 1000.0,
+                       valid ? "" : "  MISMATCH");
+            }
+        }
+    }
+
+    printf("%llu replays, %llu actions, %llu failed, %.3fs (%.0f replays/s, %.0f actions/s)\n",
+           static_cast<unsigned long long>(replayCount), static_cast<unsigned long long>(eventCount),
+           static_cast<unsigned long long>(failed), seconds, seconds > 0 ? replayCount / seconds : 0.0,
+           seconds > 0 ? eventCount / seconds : 0.0);
+    return failed == 0 ? 0 : 1;
+}
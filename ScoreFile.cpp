@@ -0,0 +1,63 @@
+#include "ScoreFile.h"
+#include <cstring>
+
+bool ScoreFile::open(const std::string& path) {
+    malformed = 0;
+    return file.open(path);
+}
+
+// Reads one or more decimal digits, without overflowing on absurdly long numbers
+static bool scanNumber(const char*& position, const char* end, int& value) {
+    const char* start = position;
+    value = 0;
+    while (position < end && *position >= '0' && *position <= '9') {
+        if (value > 1000000) return false; // Keeps minutes * 60 within an int
+        value = value * 10 + (*position - '0');
+        ++position;
+    }
+    return position != start;
+}
+
+bool ScoreFile::parseLine(const char* begin, const char* end, Record& record) {
+    if (end > begin && end[-1] == '\r') --end; // Files saved with Windows line endings
+
+    // Minutes of any length, then exactly two digits of seconds
+    const char* position = begin;
+    int minutes, seconds;
+    if (!scanNumber(position, end, minutes) || position == end || *position != ':') return false;
+    ++position;
+    const char* secondsStart = position;
+    if (end - position < 3 || !scanNumber(position, position + 2, seconds) || position != secondsStart + 2 ||
+        seconds >= 60 || *position != ',') {
+        return false;
+    }
+    ++position;
+    if (position == end) return false; // A name is required
+
+    record.time = minutes * 60 + seconds;
+    record.name = position;
+    record.nameLength = end - position;
+    return true;
+}
+
+size_t ScoreFile::parse(std::vector<Record>& records) {
+    malformed = 0;
+    const char* position = reinterpret_cast<const char*>(file.data());
+    const char* end = position + file.size();
+    size_t added = 0;
+
+    while (position < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        if (!lineEnd) lineEnd = end;
+
+        Record record;
+        if (parseLine(position, lineEnd, record)) {
+            records.push_back(record);
+            ++added;
+        } else if (lineEnd > position && !(lineEnd - position == 1 && *position == '\r')) {
+            ++malformed; // Blank lines are not counted as malformed
+        }
+        position = lineEnd + 1;
+    }
+    return added;
+}
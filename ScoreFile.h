@@ -0,0 +1,35 @@
+#ifndef SCORE_FILE_H
+#define SCORE_FILE_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Leaderboard text file of "MM:SS,Name" lines, parsed in place from a memory mapping. Records
+// point into the mapping, so parsing allocates nothing per record, and malformed lines are
+// skipped and counted instead of stopping the load.
+class ScoreFile {
+public:
+    struct Record {
+        int time;          // Seconds
+        const char* name;  // Not null-terminated, valid while the file is open
+        size_t nameLength;
+    };
+
+    bool open(const std::string& file);
+    void close() { file.close(); }
+
+    // Appends every well-formed record to `records`, returns how many were added
+    size_t parse(std::vector<Record>& records);
+    size_t getMalformedCount() const { return malformed; } // Lines skipped by the last parse()
+
+    // One line without its line break, false if it is not "MM:SS,Name"
+    static bool parseLine(const char* begin, const char* end, Record& record);
+
+private:
+    MappedFile file;
+    size_t malformed = 0;
+};
+
+#endif // SCORE_FILE_H
@@ -0,0 +1,338 @@
+#include "ScoreStore.h"
+#include "FileSync.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iterator>
+
+// Reads an unsigned decimal field of at most ten digits, never past the end of the line
+static bool scanField(const char*& position, const char* end, long long& value) {
+    const char* start = position;
+    value = 0;
+    while (position < end && *position >= '0' && *position <= '9') {
+        if (position - start == 10) return false;
+        value = value * 10 + (*position - '0');
+        ++position;
+    }
+    return position != start && value <= 0x7FFFFFFF;
+}
+
+ScoreStore::ScoreStore(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+bool ScoreStore::open(const std::string& path) {
+    close();
+    boards.clear();
+    file = path;
+    nextSequence = 0;
+    logRecords = 0;
+    keptRecords = 0;
+    malformed = 0;
+    writeFailed = false;
+
+    // Read the whole log, a missing file is an empty store
+    std::string text;
+    if (std::FILE* input = std::fopen(file.c_str(), "rb")) {
+        char chunk[65536];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), input)) > 0) {
+            text.append(chunk, read);
+        }
+        std::fclose(input);
+    }
+
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) {
+            ++malformed; // Torn last line of a write that never finished
+            break;
+        }
+
+        // "columns,rows,mines,seconds,name", or "+columns,rows,mines,seconds,count" for unnamed scores.
+        // Every field has to end inside this line, so a damaged line never borrows from the next one.
+        const char* line = text.c_str() + start;
+        const char* lineEnd = text.c_str() + end;
+        bool counted = line < lineEnd && *line == '+';
+        if (counted) ++line;
+
+        long long values[5];
+        int fields = counted ? 5 : 4;
+        bool valid = true;
+        for (int i = 0; i < fields && valid; ++i) {
+            valid = scanField(line, lineEnd, values[i]);
+            if (valid && i + 1 < fields) valid = line < lineEnd && *line++ == ',';
+        }
+        // A count ends the line, a name follows a comma and is not empty
+        if (valid) valid = counted ? line == lineEnd : line < lineEnd && *line++ == ',' && line < lineEnd;
+
+        if (valid) {
+            Key key = {static_cast<int>(values[0]), static_cast<int>(values[1]), static_cast<int>(values[2])};
+            int time = std::min(static_cast<int>(values[3]), MAX_TIME);
+            if (counted) {
+                boards[key].history.add(time, values[4]);
+            } else {
+                insert(key, time, std::string(line, lineEnd));
+            }
+            ++logRecords;
+        } else {
+            ++malformed;
+        }
+        start = end + 1;
+    }
+
+    // A damaged log is rewritten first, so new lines are not appended to a torn one
+    if (malformed > 0) {
+        LOG_WARN("Skipped %llu malformed lines in %s", static_cast<unsigned long long>(malformed), file.c_str());
+        if (!compact()) return false;
+    }
+
+    log = std::fopen(file.c_str(), "ab");
+    if (!log) {
+        LOG_ERROR("Failed to open score log %s", file.c_str());
+        return false;
+    }
+    LOG_INFO("Loaded %llu scores for %zu boards from %s", static_cast<unsigned long long>(logRecords), boards.size(),
+             file.c_str());
+    return true;
+}
+
+void ScoreStore::close() {
+    if (log) {
+        std::fclose(log);
+        log = nullptr;
+    }
+}
+
+void ScoreStore::insert(const Key& key, int time, const std::string& name) {
+    BoardScores& board = boards[key];
+    Entry entry = {time, nextSequence++, name};
+    board.history.add(time, 1);
+
+    // A full ranking only takes scores that beat its slowest one
+    if (board.top.size() < capacity || Order()(entry, *board.top.rbegin())) {
+        board.top.insert(entry);
+        ++keptRecords;
+        if (board.top.size() > capacity) {
+            board.top.erase(std::prev(board.top.end()));
+            --keptRecords;
+        }
+    }
+
+    // Replace the player's personal best if this one is faster
+    auto best = board.bests.find(name);
+    if (best == board.bests.end()) {
+        board.bests.insert(std::make_pair(name, entry));
+        ++keptRecords;
+    } else if (time < best->second.time) {
+        board.bestOrder.erase(best->second);
+        board.bestIndex.add(best->second.time, -1);
+        best->second = entry;
+    } else {
+        return;
+    }
+    board.bestOrder.insert(entry);
+    board.bestIndex.add(time, 1);
+}
+
+std::uint64_t ScoreStore::add(const Key& key, int time, const std::string& name) {
+    // Line breaks would split the record
+    std::string cleanName = name;
+    std::replace(cleanName.begin(), cleanName.end(), '\n', ' ');
+    std::replace(cleanName.begin(), cleanName.end(), '\r', ' ');
+    if (cleanName.empty()) cleanName = "?";
+
+    time = std::min(std::max(time, 0), MAX_TIME);
+    std::uint64_t sequence = nextSequence;
+    insert(key, time, cleanName);
+
+    if (log) {
+        Entry entry = {time, sequence, cleanName};
+        if (writeRecord(log, key, entry) && (batching || syncFile(log))) {
+            ++logRecords;
+        } else {
+            LOG_ERROR("Failed to append a score to %s", file.c_str());
+            writeFailed = true;
+        }
+
+        // Compact once most of the log is scores that are only counted
+        if (!batching && logRecords > 1024 && logRecords > 4 * keptRecords) {
+            compact();
+        }
+    }
+    return sequence;
+}
+
+void ScoreStore::endBatch() {
+    batching = false;
+    if (!log) return;
+    if (!syncFile(log)) {
+        LOG_ERROR("Failed to append scores to %s", file.c_str());
+        writeFailed = true;
+    }
+    if (logRecords > 1024 && logRecords > 4 * keptRecords) {
+        compact();
+    }
+}
+
+bool ScoreStore::compact() {
+    if (file.empty()) return false;
+
+    // Named scores still kept (top scores and personal bests) in the order they were recorded,
+    // so ties keep their order after reloading
+    std::vector<std::pair<const Key*, const Entry*>> records;
+    records.reserve(keptRecords);
+    for (const auto& board : boards) {
+        for (const Entry& entry : board.second.top) {
+            records.push_back(std::make_pair(&board.first, &entry));
+        }
+        for (const Entry& entry : board.second.bestOrder) {
+            if (board.second.top.count(entry) == 0) records.push_back(std::make_pair(&board.first, &entry));
+        }
+    }
+    std::sort(records.begin(), records.end(),
+              [](const std::pair<const Key*, const Entry*>& a, const std::pair<const Key*, const Entry*>& b) {
+                  return a.second->sequence < b.second->sequence;
+              });
+
+    // Every other score only survives as a count per board and time
+    std::map<std::pair<Key, int>, std::int64_t> counts;
+    for (const auto& board : boards) {
+        const FenwickTree& history = board.second.history;
+        for (int time = 0; time < history.size(); ++time) {
+            std::uint64_t count = history.get(time);
+            if (count > 0) counts[std::make_pair(board.first, time)] = count;
+        }
+    }
+    for (const auto& record : records) {
+        --counts[std::make_pair(*record.first, record.second->time)];
+    }
+
+    std::string temporary = file + ".tmp";
+    std::FILE* output = std::fopen(temporary.c_str(), "wb");
+    if (!output) {
+        LOG_ERROR("Failed to compact score log %s", file.c_str());
+        return false;
+    }
+    bool written = true;
+    size_t lines = records.size();
+    for (const auto& count : counts) {
+        if (count.second <= 0) continue;
+        const Key& key = count.first.first;
+        written = std::fprintf(output, "+%d,%d,%d,%d,%lld\n", key.columns, key.rows, key.mines, count.first.second,
+                               static_cast<long long>(count.second)) > 0 && written;
+        ++lines;
+    }
+    for (const auto& record : records) {
+        written = writeRecord(output, *record.first, *record.second) && written;
+    }
+    // The new log has to be on disk before it replaces the old one
+    written = syncFile(output) && written;
+    if (std::fclose(output) != 0 || !written) {
+        std::remove(temporary.c_str());
+        LOG_ERROR("Failed to compact score log %s", file.c_str());
+        return false;
+    }
+
+    // Swap the new log in, reopening the append handle on it
+    bool reopen = log != nullptr;
+    close();
+    bool renamed = replaceFile(temporary, file);
+    if (renamed) logRecords = lines;
+    if (reopen) {
+        log = std::fopen(file.c_str(), "ab");
+        if (!log) LOG_ERROR("Failed to reopen score log %s", file.c_str());
+    }
+    LOG_INFO("Compacted %s to %zu lines", file.c_str(), lines);
+    return renamed;
+}
+
+const ScoreStore::BoardScores* ScoreStore::find(const Key& key) const {
+    auto board = boards.find(key);
+    return board == boards.end() ? nullptr : &board->second;
+}
+
+std::vector<ScoreStore::Entry> ScoreStore::top(const Key& key, size_t count) const {
+    std::vector<Entry> result;
+    const BoardScores* board = find(key);
+    if (!board) return result;
+
+    for (const Entry& entry : board->top) {
+        if (result.size() == count) break;
+        result.push_back(entry);
+    }
+    return result;
+}
+
+size_t ScoreStore::getKeptCount(const Key& key) const {
+    const BoardScores* board = find(key);
+    return board ? board->top.size() : 0;
+}
+
+std::uint64_t ScoreStore::getScoreCount(const Key& key) const {
+    const BoardScores* board = find(key);
+    return board ? board->history.getTotal() : 0;
+}
+
+std::uint64_t ScoreStore::getRank(const Key& key, int time) const {
+    const BoardScores* board = find(key);
+    return board ? board->history.prefix(std::min(time, MAX_TIME) - 1) + 1 : 1;
+}
+
+double ScoreStore::getPercentile(const Key& key, int time) const {
+    const BoardScores* board = find(key);
+    if (!board || board->history.getTotal() == 0) return 100.0;
+    return 100.0 * board->history.prefix(std::min(time, MAX_TIME)) / board->history.getTotal();
+}
+
+std::uint64_t ScoreStore::countBetween(const Key& key, int fastest, int slowest) const {
+    const BoardScores* board = find(key);
+    if (!board || slowest < fastest) return 0;
+    return board->history.prefix(std::min(slowest, MAX_TIME)) - board->history.prefix(std::min(fastest, MAX_TIME) - 1);
+}
+
+bool ScoreStore::getPersonalBest(const Key& key, const std::string& name, Entry& best) const {
+    const BoardScores* board = find(key);
+    if (!board) return false;
+    auto entry = board->bests.find(name);
+    if (entry == board->bests.end()) return false;
+    best = entry->second;
+    return true;
+}
+
+size_t ScoreStore::getPlayerCount(const Key& key) const {
+    const BoardScores* board = find(key);
+    return board ? board->bests.size() : 0;
+}
+
+std::uint64_t ScoreStore::getPlayerRank(const Key& key, const std::string& name) const {
+    Entry best;
+    if (!getPersonalBest(key, name, best)) return 0;
+    return find(key)->bestIndex.prefix(best.time - 1) + 1; // Players with equal bests share a rank
+}
+
+std::vector<ScoreStore::Entry> ScoreStore::playerPage(const Key& key, size_t first, size_t count) const {
+    std::vector<Entry> result;
+    const BoardScores* board = find(key);
+    if (!board || first >= board->bestOrder.size()) return result;
+
+    // The index finds the time of the first player on the page, the ordered set continues from there.
+    // Only players tied at that time are stepped over one by one.
+    int time = board->bestIndex.findKth(first + 1);
+    std::uint64_t before = board->bestIndex.prefix(time - 1);
+    Entry start = {time, 0, std::string()};
+    auto entry = board->bestOrder.lower_bound(start);
+    std::advance(entry, first - before);
+
+    for (; entry != board->bestOrder.end() && result.size() < count; ++entry) {
+        result.push_back(*entry);
+    }
+    return result;
+}
+
+bool ScoreStore::writeRecord(std::FILE* output, const Key& key, const Entry& entry) {
+    return std::fprintf(output, "%d,%d,%d,%d,%s\n", key.columns, key.rows, key.mines, entry.time,
+                        entry.name.c_str()) > 0;
+}
@@ -0,0 +1,120 @@
+#ifndef SCORE_STORE_H
+#define SCORE_STORE_H
+
+#include "FenwickTree.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Persistent best times, kept separately for every board configuration. Scores are appended to
+// a log, one "columns,rows,mines,seconds,name" line each, and synced to disk right away, so a
+// crash or power loss can at most lose the line being written (a torn last line is skipped on load).
+//
+// In memory every board keeps its best `capacity` scores, every player's personal best, and a
+// count of all scores ever recorded per second of time, which answers rank and percentile
+// queries in O(log n). Once the log holds mostly scores that are neither, it is rewritten: the
+// named scores that are still kept, plus "+columns,rows,mines,seconds,count" lines for the rest,
+// so ranks stay exact. The new log goes to a temporary file that is synced and then renamed over
+// the old one, so there is never a moment without a complete copy on disk.
+class ScoreStore {
+public:
+    struct Key {
+        int columns;
+        int rows;
+        int mines;
+
+        bool operator<(const Key& other) const {
+            if (columns != other.columns) return columns < other.columns;
+            if (rows != other.rows) return rows < other.rows;
+            return mines < other.mines;
+        }
+    };
+
+    struct Entry {
+        int time;                // Seconds
+        std::uint64_t sequence;  // Order the score was recorded in, earlier wins a tie
+        std::string name;
+    };
+
+    explicit ScoreStore(size_t capacity = 100);
+    ~ScoreStore();
+
+    bool open(const std::string& file); // Load the log (a missing one is empty) and append to it from now on
+    void close();
+
+    // Records a score in O(log n) and appends it to the log. Returns its sequence number.
+    std::uint64_t add(const Key& key, int time, const std::string& name);
+    // Between these, added scores are written to the log without a sync each, for bulk imports
+    void beginBatch() { batching = true; }
+    void endBatch();
+    bool compact(); // Rewrite the log with the kept scores and counts of the others
+
+    // The best `count` kept scores of a board, fastest first
+    std::vector<Entry> top(const Key& key, size_t count) const;
+    size_t getKeptCount(const Key& key) const;
+    bool isEmpty() const { return boards.empty(); }
+    // False once the log could not be opened or a score could not be written to it; later scores
+    // are then only kept in memory. Cleared by the next successful open().
+    bool isSaving() const { return log != nullptr && !writeFailed; }
+
+    // Queries over every score ever recorded for a board, O(log n) each
+    std::uint64_t getScoreCount(const Key& key) const;
+    std::uint64_t getRank(const Key& key, int time) const;        // 1 + number of strictly faster scores
+    double getPercentile(const Key& key, int time) const;         // Share of scores at least this fast, in percent
+    std::uint64_t countBetween(const Key& key, int fastest, int slowest) const; // Scores with time in [fastest, slowest]
+
+    // Personal bests, one per player
+    bool getPersonalBest(const Key& key, const std::string& name, Entry& best) const;
+    size_t getPlayerCount(const Key& key) const;
+    std::uint64_t getPlayerRank(const Key& key, const std::string& name) const; // 0 if the player has no score
+    // Players ranked by personal best: `count` of them starting at zero-based rank `first`
+    std::vector<Entry> playerPage(const Key& key, size_t first, size_t count) const;
+
+    std::uint64_t getLogRecordCount() const { return logRecords; }
+    std::uint64_t getMalformedCount() const { return malformed; } // Lines skipped by the last open()
+
+private:
+    struct Order {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.time != b.time ? a.time < b.time : a.sequence < b.sequence;
+        }
+    };
+    typedef std::set<Entry, Order> Ranking;
+
+    struct BoardScores {
+        Ranking top;                                        // Best `capacity` scores
+        FenwickTree history;                                // Every score, counted by time
+        std::unordered_map<std::string, Entry> bests;       // Personal best per player
+        Ranking bestOrder;                                  // The personal bests, fastest first
+        FenwickTree bestIndex;                              // The personal bests, counted by time
+    };
+
+    // Slower times are counted as this, the longest the MM:SS timer shows. It bounds the Fenwick
+    // trees to 8192 keys, so one outlier cannot size them for weeks of seconds.
+    static const int MAX_TIME = 99 * 60 + 59;
+
+    size_t capacity;
+    std::map<Key, BoardScores> boards;
+    std::string file;
+    std::FILE* log = nullptr;
+    std::uint64_t nextSequence = 0;
+    std::uint64_t logRecords = 0;  // Lines in the log file
+    std::uint64_t keptRecords = 0; // Named scores a compacted log would keep, at most
+    std::uint64_t malformed = 0;
+    bool batching = false;
+    bool writeFailed = false;
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    void insert(const Key& key, int time, const std::string& name); // In memory only
+    const BoardScores* find(const Key& key) const;
+    static bool writeRecord(std::FILE* output, const Key& key, const Entry& entry);
+};
+
+#endif // SCORE_STORE_H
@@ -0,0 +1,259 @@
+// Headless simulation farm: plays many games with a strategy on every core and reports win
+// rate, clicks, 3BV and timing. Every game has its own seed, derived from the base seed and the
+// game number, so results do not depend on the number of threads or on scheduling.
+#include "GameEngine.h"
+#include "Random.h"
+#include "Strategy.h"
+#include "Telemetry.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+struct Options {
+    int columns = 30;
+    int rows = 16;
+    int mines = 99;
+    uint64_t games = 100000;
+    string strategy = "probability";
+    GameEngine::Generation generation = GameEngine::Generation::SafeFirstClick;
+    unsigned threads = 0;    // Every hardware thread
+    uint64_t seed = 1;
+    uint64_t batchSize = 256; // Games per pool task
+    string outputFile;       // JSON report, none if empty
+};
+
+// Totals of one worker, merged once at the end so workers never write shared memory
+struct Stats {
+    uint64_t games = 0;
+    uint64_t wins = 0;
+    uint64_t clicks = 0;
+    uint64_t winClicks = 0;
+    uint64_t value3BV = 0;
+    uint64_t win3BV = 0;
+    LatencyHistogram gameTime;
+
+    void merge(const Stats& other) {
+        games += other.games;
+        wins += other.wins;
+        clicks += other.clicks;
+        winClicks += other.winClicks;
+        value3BV += other.value3BV;
+        win3BV += other.win3BV;
+        gameTime.merge(other.gameTime);
+    }
+};
+
+// Everything one worker reuses from game to game
+struct Worker {
+    GameEngine engine;
+    unique_ptr<Strategy> strategy;
+    Stats stats;
+    vector<char> seen;
+    vector<int> stack;
+
+    Worker(const Options& options)
+        : engine(options.columns, options.rows, options.mines, options.seed, options.generation),
+          strategy(createStrategy(options.strategy)) {
+        // Every worker already has a core, so a no-guess search must not start threads of its own
+        engine.setGeneratorThreads(1);
+    }
+};
+
+// 3BV: the fewest clicks that clear the board. One per opening (a connected region of zero
+// cells together with its numbered border) plus one per numbered cell outside every opening.
+static int board3BV(const Board& board, vector<char>& seen, vector<int>& stack) {
+    const int columns = board.getColumns();
+    const int rows = board.getRows();
+    seen.assign(board.size(), 0);
+    int value = 0;
+
+    for (int index = 0; index < board.size(); ++index) {
+        if (seen[index] || board[index].isMine() || board[index].adjacentMines() != 0) continue;
+
+        ++value;
+        seen[index] = 1;
+        stack.assign(1, index);
+        while (!stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            int row = current / columns, col = current % columns;
+            for (int r = max(row - 1, 0); r <= min(row + 1, rows - 1); ++r) {
+                for (int c = max(col - 1, 0); c <= min(col + 1, columns - 1); ++c) {
+                    int neighbor = r * columns + c;
+                    if (seen[neighbor]) continue;
+                    seen[neighbor] = 1;
+                    if (board[neighbor].adjacentMines() == 0) stack.push_back(neighbor);
+                }
+            }
+        }
+    }
+    for (int index = 0; index < board.size(); ++index) {
+        if (!seen[index] && !board[index].isMine()) ++value;
+    }
+    return value;
+}
+
+static void playGame(const Options& options, Worker& worker, uint64_t game) {
+    GameEngine& engine = worker.engine;
+    Strategy& strategy = *worker.strategy;
+    uint64_t seed = Random::streamSeed(options.seed, game);
+    Clock::time_point start = Clock::now();
+
+    engine.reset(seed);
+    strategy.newGame(engine, Random::streamSeed(~options.seed, game)); // A separate stream for the player
+    const Board& board = engine.getBoard();
+
+    uint64_t clicks = 0;
+    while (!engine.isOver()) {
+        Strategy::Move move = strategy.nextMove(engine);
+        if (move.index < 0) break;
+
+        int row = board.rowOf(move.index), col = board.colOf(move.index);
+        bool changed = move.flag ? engine.toggleFlag(row, col) : engine.reveal(row, col);
+        if (!changed) break; // A strategy that repeats itself would never finish
+        ++clicks;
+        strategy.moved(engine);
+    }
+
+    Stats& stats = worker.stats;
+    stats.gameTime.record(chrono::duration<double, micro>(Clock::now() - start).count());
+    int value = board3BV(board, worker.seen, worker.stack);
+    ++stats.games;
+    stats.clicks += clicks;
+    stats.value3BV += value;
+    if (engine.isWon()) {
+        ++stats.wins;
+        stats.winClicks += clicks;
+        stats.win3BV += value;
+    }
+}
+
+static void writeReport(FILE* output, const Options& options, const Stats& total, unsigned threads, double seconds) {
+    double winRate = total.games ? static_cast<double>(total.wins) / total.games : 0.0;
+
+    // 95% Wilson score interval for the win rate
+    const double z = 1.96;
+    double n = static_cast<double>(total.games);
+    double center = n > 0 ? (winRate + z * z / (2 * n)) / (1 + z * z / n) : 0.0;
+    double margin = n > 0 ? z * sqrt(winRate * (1 - winRate) / n + z * z / (4 * n * n)) / (1 + z * z / n) : 0.0;
+
+    fprintf(output,
+            "{\n  \"strategy\": \"%s\", \"columns\": %d, \"rows\": %d, \"mines\": %d, \"seed\": %llu, \"threads\": %u,\n"
+            "  \"games\": %llu, \"wins\": %llu, \"win_rate\": %.5f, \"win_rate_low\": %.5f, \"win_rate_high\": %.5f,\n"
+            "  \"mean_clicks\": %.3f, \"mean_win_clicks\": %.3f, \"mean_3bv\": %.3f, \"mean_win_3bv\": %.3f,\n"
+            "  \"game_mean_us\": %.1f, \"game_p50_us\": %.1f, \"game_p99_us\": %.1f, \"game_max_us\": %.1f,\n"
+            "  \"seconds\": %.3f, \"games_per_second\": %.0f\n}\n",
+            options.strategy.c_str(), options.columns, options.rows, options.mines,
+            static_cast<unsigned long long>(options.seed), threads, static_cast<unsigned long long>(total.games),
+            static_cast<unsigned long long>(total.wins), winRate, center - margin, center + margin,
+            total.games ? static_cast<double>(total.clicks) / total.games : 0.0,
+            total.wins ? static_cast<double>(total.winClicks) / total.wins : 0.0,
+            total.games ? static_cast<double>(total.value3BV) / total.games : 0.0,
+            total.wins ? static_cast<double>(total.win3BV) / total.wins : 0.0, total.gameTime.getMean(),
+            total.gameTime.getPercentile(50), total.gameTime.getPercentile(99), total.gameTime.getMax(), seconds,
+            seconds > 0 ? total.games / seconds : 0.0);
+}
+
+static bool parseGeneration(const string& name, GameEngine::Generation& generation) {
+    if (name == "random") {
+        generation = GameEngine::Generation::Random;
+    } else if (name == "safe") {
+        generation = GameEngine::Generation::SafeFirstClick;
+    } else if (name == "no-guess") {
+        generation = GameEngine::Generation::NoGuess;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (option == "--size" && hasValue) {
+            valid = sscanf(argv[++i], "%dx%d", &options.columns, &options.rows) == 2 && options.columns > 0 &&
+                    options.rows > 0;
+        } else if (option == "--mines" && hasValue) {
+            options.mines = atoi(argv[++i]);
+        } else if (option == "--games" && hasValue) {
+            options.games = strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--strategy" && hasValue) {
+            options.strategy = argv[++i];
+            valid = createStrategy(options.strategy) != nullptr;
+        } else if (option == "--generation" && hasValue) {
+            valid = parseGeneration(argv[++i], options.generation);
+        } else if (option == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(max(0, atoi(argv[++i])));
+        } else if (option == "--seed" && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--batch" && hasValue) {
+            options.batchSize = max<uint64_t>(1, strtoull(argv[++i], nullptr, 10));
+        } else if (option == "--output" && hasValue) {
+            options.outputFile = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            string names;
+            for (const string& name : strategyNames()) names += (names.empty() ? "" : "|") + name;
+            fprintf(stderr,
+                    "Usage: %s [--size 30x16] [--mines 99] [--games n] [--strategy %s]\n"
+                    "          [--generation random|safe|no-guess] [--threads n] [--seed n] [--batch n]\n"
+                    "          [--output report.json]\n",
+                    argv[0], names.c_str());
+            return option == "--help" ? 0 : 1;
+        }
+    }
+
+    ThreadPool pool(options.threads);
+    vector<unique_ptr<Worker>> workers;
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        workers.emplace_back(new Worker(options));
+    }
+
+    // Games are handed out in batches; idle workers steal whole batches from busy ones
+    Clock::time_point start = Clock::now();
+    for (uint64_t first = 0; first < options.games; first += options.batchSize) {
+        uint64_t last = min(options.games, first + options.batchSize);
+        pool.submit([&options, &workers, first, last](unsigned worker) {
+            for (uint64_t game = first; game < last; ++game) {
+                playGame(options, *workers[worker], game);
+            }
+        });
+    }
+    pool.wait();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    Stats total;
+    for (const unique_ptr<Worker>& worker : workers) {
+        total.merge(worker->stats);
+    }
+
+    writeReport(stdout, options, total, pool.size(), seconds);
+    if (!options.outputFile.empty()) {
+        FILE* output = fopen(options.outputFile.c_str(), "w");
+        if (!output) {
+            fprintf(stderr, "Failed to open %s\n", options.outputFile.c_str());
+            return 1;
+        }
+        writeReport(output, options, total, pool.size(), seconds);
+        fclose(output);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "Snapshot.h"
+#include "FileSync.h"
+#include "Logger.h"
+#include <cstdio>
+#include <cstring>
+
+static std::uint64_t alignUp(std::uint64_t offset) { return (offset + 7) & ~static_cast<std::uint64_t>(7); }
+
+bool SnapshotFile::open(const std::string& path) {
+    close();
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) {
+        file.close();
+        return false;
+    }
+    data = file.data();
+    size = file.size();
+
+    // Only the header is checked here, GameEngine::restore() checks the cells against it
+    const SnapshotHeader& header = getHeader();
+    std::uint64_t cells = static_cast<std::uint64_t>(header.columns) * static_cast<std::uint64_t>(header.rows);
+    bool valid = header.magic == SnapshotHeader::MAGIC && header.version == SnapshotHeader::VERSION &&
+                 header.headerSize == sizeof(SnapshotHeader) && header.fileSize == size && header.columns > 0 &&
+                 header.rows > 0 && cells <= 0x7FFFFFFF && header.mines >= 0 &&
+                 header.minePositionCount >= 0 && header.minePositionCount <= header.mines &&
+                 header.generation <= static_cast<std::uint8_t>(GameEngine::Generation::NoGuess) &&
+                 header.state <= static_cast<std::uint8_t>(GameEngine::State::Lost) &&
+                 header.minesOffset == alignUp(sizeof(SnapshotHeader)) &&
+                 header.cellsOffset == alignUp(header.minesOffset + 4 * static_cast<std::uint64_t>(header.minePositionCount)) &&
+                 header.cellsOffset + cells == size;
+    if (!valid) {
+        LOG_WARN("%s is not a valid snapshot", path.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SnapshotFile::close() {
+    file.close();
+    data = nullptr;
+    size = 0;
+}
+
+GameEngine::SavedState SnapshotFile::getSavedState() const {
+    const SnapshotHeader& header = getHeader();
+    GameEngine::SavedState saved;
+    saved.seed = header.seed;
+    saved.state = static_cast<GameEngine::State>(header.state);
+    saved.generated = header.generated != 0;
+    saved.cells = reinterpret_cast<const Cell*>(data + header.cellsOffset);
+    saved.minePositions = reinterpret_cast<const std::int32_t*>(data + header.minesOffset);
+    saved.minePositionCount = header.minePositionCount;
+    saved.flagCount = header.flagCount;
+    saved.correctFlagCount = header.correctFlagCount;
+    saved.revealedSafeCount = header.revealedSafeCount;
+    return saved;
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (thread.joinable()) thread.join();
+}
+
+void SnapshotWriter::save(const GameEngine& engine, std::uint64_t elapsedMilliseconds, const std::string& file) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        encode(engine, elapsedMilliseconds, pending); // A copy of the state, the disk work happens on the thread
+        pendingFile = file;
+        hasPending = true;
+        if (!thread.joinable()) thread = std::thread(&SnapshotWriter::run, this);
+    }
+    wake.notify_one();
+}
+
+void SnapshotWriter::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return !hasPending && !busy; });
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return hasPending || stopping; });
+        if (!hasPending) break; // Stopping with nothing left to write
+
+        writing.swap(pending);
+        std::string file = pendingFile;
+        hasPending = false;
+        busy = true;
+
+        lock.unlock();
+        if (!write(writing, file)) {
+            LOG_ERROR("Failed to save the game to %s", file.c_str());
+        }
+        lock.lock();
+
+        busy = false;
+        done.notify_all();
+    }
+}
+
+void SnapshotWriter::encode(const GameEngine& engine, std::uint64_t elapsedMilliseconds, std::vector<std::uint8_t>& output) {
+    const Board& board = engine.getBoard();
+    const std::vector<int>& minePositions = engine.getMinePositions();
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SnapshotHeader::MAGIC;
+    header.version = SnapshotHeader::VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.columns = board.getColumns();
+    header.rows = board.getRows();
+    header.mines = engine.getMines();
+    header.generation = static_cast<std::uint8_t>(engine.getGeneration());
+    header.state = static_cast<std::uint8_t>(engine.getState());
+    header.generated = engine.isGenerated() ? 1 : 0;
+    header.flagCount = engine.getFlagCount();
+    header.correctFlagCount = engine.getCorrectFlagCount();
+    header.revealedSafeCount = engine.getRevealedSafeCount();
+    header.minePositionCount = static_cast<std::int32_t>(minePositions.size());
+    header.seed = engine.getSeed();
+    header.elapsedMilliseconds = elapsedMilliseconds;
+    header.minesOffset = alignUp(sizeof(SnapshotHeader));
+    header.cellsOffset = alignUp(header.minesOffset + 4 * minePositions.size());
+    header.fileSize = header.cellsOffset + board.size();
+
+    // Sized without clearing, every byte is written below (the alignment gaps explicitly)
+    output.resize(header.fileSize);
+    std::memset(output.data() + sizeof(header), 0, header.minesOffset - sizeof(header));
+    std::memset(output.data() + header.minesOffset + 4 * minePositions.size(), 0,
+                header.cellsOffset - header.minesOffset - 4 * minePositions.size());
+    std::memcpy(output.data(), &header, sizeof(header));
+    for (size_t i = 0; i < minePositions.size(); ++i) {
+        std::int32_t position = minePositions[i];
+        std::memcpy(output.data() + header.minesOffset + 4 * i, &position, 4);
+    }
+    std::memcpy(output.data() + header.cellsOffset, board.data(), board.size());
+}
+
+bool SnapshotWriter::write(const std::vector<std::uint8_t>& snapshot, const std::string& file) {
+    std::string temporary = file + ".tmp";
+    std::FILE* output = std::fopen(temporary.c_str(), "wb");
+    if (!output) return false;
+
+    // The new snapshot has to be on disk before it replaces the old one
+    bool written = std::fwrite(snapshot.data(), 1, snapshot.size(), output) == snapshot.size() && syncFile(output);
+    if (std::fclose(output) != 0 || !written) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return replaceFile(temporary, file);
+}
@@ -0,0 +1,101 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "GameEngine.h"
+#include "MappedFile.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed binary layout of a saved game, in the byte order of the machine that wrote it:
+//   SnapshotHeader, the mine positions (int32 each), then one byte per cell in the Cell format.
+// Both arrays start at 8-byte aligned offsets, so a mapped file is used in place with no parsing.
+struct SnapshotHeader {
+    static const std::uint32_t MAGIC = 0x5353534D; // "MSSS"
+    static const std::uint32_t VERSION = 1;
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;         // sizeof(SnapshotHeader) of the writer
+    std::int32_t columns;
+    std::int32_t rows;
+    std::int32_t mines;
+    std::uint8_t generation;          // GameEngine::Generation
+    std::uint8_t state;               // GameEngine::State
+    std::uint8_t generated;
+    std::uint8_t reserved;
+    std::int32_t flagCount;
+    std::int32_t correctFlagCount;
+    std::int32_t revealedSafeCount;
+    std::int32_t minePositionCount;
+    std::uint32_t padding;            // Keeps the 64-bit fields aligned
+    std::uint64_t seed;
+    std::uint64_t elapsedMilliseconds; // Game time, pauses excluded
+    std::uint64_t minesOffset;
+    std::uint64_t cellsOffset;
+    std::uint64_t fileSize;
+};
+static_assert(sizeof(SnapshotHeader) == 88, "SnapshotHeader must keep its on-disk layout");
+static_assert(sizeof(Cell) == 1, "Snapshots store cells as single bytes");
+
+// Read-only view of a snapshot file, memory-mapped where the platform allows it
+class SnapshotFile {
+public:
+    SnapshotFile() {}
+    ~SnapshotFile() { close(); }
+
+    bool open(const std::string& file); // False if missing, truncated or not a snapshot of this version
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const SnapshotHeader& getHeader() const { return *reinterpret_cast<const SnapshotHeader*>(data); }
+    GameEngine::Generation getGeneration() const { return static_cast<GameEngine::Generation>(getHeader().generation); }
+    GameEngine::SavedState getSavedState() const; // Points into the mapping, valid while the file is open
+
+private:
+    MappedFile file;
+    const std::uint8_t* data = nullptr;
+    size_t size = 0;
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+};
+
+// Writes snapshots on a background thread. save() only copies the engine state into a buffer,
+// the file is written to a temporary name, synced and renamed over the old one, so neither a
+// crash nor a power loss leaves a half-written save behind. A request that has not started yet is replaced by a newer one.
+class SnapshotWriter {
+public:
+    SnapshotWriter() {}
+    ~SnapshotWriter(); // Finishes the pending write
+
+    void save(const GameEngine& engine, std::uint64_t elapsedMilliseconds, const std::string& file);
+    void wait(); // Block until every requested snapshot is on disk
+
+    // Serializes into `output`, reusing its capacity
+    static void encode(const GameEngine& engine, std::uint64_t elapsedMilliseconds, std::vector<std::uint8_t>& output);
+    static bool write(const std::vector<std::uint8_t>& snapshot, const std::string& file);
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::uint8_t> pending;
+    std::vector<std::uint8_t> writing; // Swapped with pending, so neither buffer is reallocated per save
+    std::string pendingFile;
+    bool hasPending = false;
+    bool busy = false;
+    bool stopping = false;
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void run();
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,273 @@
+#include "Solver.h"
+#include <algorithm>
+
+// Spreads the 3x3 mask of a number at offset (dr, dc) into the 7x7 window centred on another number
+static std::uint64_t spread(std::uint16_t mask, int dr, int dc) {
+    std::uint64_t window = 0;
+    for (int i = 0; i < 3; ++i) {
+        window |= static_cast<std::uint64_t>((mask >> (3 * i)) & 7) << ((2 + dr + i) * 7 + 2 + dc);
+    }
+    return window;
+}
+
+void Solver::reset(const GameEngine& engine) {
+    const Board& board = engine.getBoard();
+    columns = board.getColumns();
+    rows = board.getRows();
+
+    unknown.resize(board.size());
+    safe.resize(board.size());
+    mines.resize(board.size());
+    flagged.resize(board.size());
+    frontier.resize(board.size());
+    queued.resize(board.size());
+    hiddenMask.assign(board.size(), 0);
+    needed.assign(board.size(), 0);
+    worklist.clear();
+    worklistHead = 0;
+    safeCells.clear();
+    mineCells.clear();
+    unknownCount = 0;
+    safeCount = 0;
+    mineCount = 0;
+    remainingMines = engine.getRemainingMines();
+
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (cell.isRevealed()) continue;
+        if (cell.isFlagged()) {
+            flagged.set(index);
+        } else {
+            unknown.set(index);
+            ++unknownCount;
+        }
+    }
+    for (int index = 0; index < board.size(); ++index) {
+        if (board[index].isRevealed() && !board[index].isMine()) addConstraint(index, board[index].adjacentMines());
+    }
+    propagate();
+}
+
+void Solver::update(const GameEngine& engine, const std::vector<int>& changedCells) {
+    if (engine.isLost() || engine.getBoard().size() != unknown.size()) return;
+
+    const Board& board = engine.getBoard();
+    remainingMines = engine.getRemainingMines();
+
+    for (int index : changedCells) {
+        Cell cell = board[index];
+        if (cell.isRevealed()) {
+            if (safe.test(index)) {
+                safe.reset(index);
+                --safeCount;
+            } else if (unknown.test(index)) {
+                known(index, false);
+            } else {
+                continue; // Already seen as revealed
+            }
+            addConstraint(index, cell.adjacentMines());
+        } else if (cell.isFlagged()) {
+            if (flagged.test(index)) continue;
+            flagged.set(index);
+            if (mines.test(index)) {
+                mines.reset(index);
+                --mineCount;
+            } else if (unknown.test(index)) {
+                known(index, true);
+            } else {
+                return reset(engine); // A flag on a proven safe cell, start over trusting the flag
+            }
+        } else if (flagged.test(index)) {
+            return reset(engine); // A flag was removed, deductions that relied on it no longer hold
+        }
+    }
+    propagate();
+}
+
+const std::vector<int>& Solver::getSafeCells() {
+    // Drop cells that were revealed since they were deduced
+    safeCells.erase(std::remove_if(safeCells.begin(), safeCells.end(), [this](int index) { return !safe.test(index); }),
+                    safeCells.end());
+    return safeCells;
+}
+
+const std::vector<int>& Solver::getMineCells() {
+    mineCells.erase(std::remove_if(mineCells.begin(), mineCells.end(), [this](int index) { return !mines.test(index); }),
+                    mineCells.end());
+    return mineCells;
+}
+
+void Solver::addConstraint(int index, int adjacentMines) {
+    const int row = index / columns, col = index % columns;
+    std::uint16_t mask = 0;
+    int count = 0;
+
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); ++r) {
+        for (int c = std::max(col - 1, 0); c <= std::min(col + 1, columns - 1); ++c) {
+            int neighbor = r * columns + c;
+            if (unknown.test(neighbor)) {
+                mask |= 1 << ((r - row + 1) * 3 + (c - col + 1));
+                frontier.set(neighbor);
+            } else if (flagged.test(neighbor) || mines.test(neighbor)) {
+                ++count;
+            }
+        }
+    }
+    hiddenMask[index] = mask;
+    needed[index] = static_cast<std::int8_t>(adjacentMines - count);
+    if (mask) enqueue(index);
+}
+
+void Solver::known(int index, bool isMine) {
+    unknown.reset(index);
+    frontier.reset(index);
+    --unknownCount;
+
+    // Take the cell out of the numbers around it
+    const int row = index / columns, col = index % columns;
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, rows - 1); ++r) {
+        for (int c = std::max(col - 1, 0); c <= std::min(col + 1, columns - 1); ++c) {
+            int neighbor = r * columns + c;
+            std::uint16_t bit = 1 << ((row - r + 1) * 3 + (col - c + 1));
+            if (!(hiddenMask[neighbor] & bit)) continue;
+
+            hiddenMask[neighbor] &= ~bit;
+            if (isMine) --needed[neighbor];
+            enqueue(neighbor);
+        }
+    }
+}
+
+bool Solver::mark(int index, bool isMine) {
+    if (!unknown.test(index)) return false;
+
+    known(index, isMine);
+    if (isMine) {
+        mines.set(index);
+        mineCells.push_back(index);
+        ++mineCount;
+    } else {
+        safe.set(index);
+        safeCells.push_back(index);
+        ++safeCount;
+    }
+    return true;
+}
+
+int Solver::markWindow(int center, std::uint64_t window, bool isMine) {
+    const int row = center / columns, col = center % columns;
+    int marked = 0;
+    for (; window; window &= window - 1) {
+        int bit = lowestBit(window);
+        marked += mark((row + bit / 7 - 3) * columns + col + bit % 7 - 3, isMine);
+    }
+    return marked;
+}
+
+void Solver::enqueue(int index) {
+    if (queued.test(index)) return;
+    queued.set(index);
+    worklist.push_back(index);
+}
+
+void Solver::process(int a) {
+    std::uint16_t maskA = hiddenMask[a];
+    if (!maskA) return;
+
+    int needA = needed[a];
+    int countA = popCount(maskA);
+    if (needA < 0 || needA > countA) return; // Contradicts the flags, so some flag is wrong
+
+    // Single-cell rule: the number is already satisfied, or needs every hidden neighbour
+    std::uint64_t windowA = spread(maskA, 0, 0);
+    if (needA == 0 || needA == countA) {
+        markWindow(a, windowA, needA != 0);
+        return;
+    }
+
+    // Pair rules against every number close enough to share a hidden cell
+    const int row = a / columns, col = a % columns;
+    for (int r = std::max(row - 2, 0); r <= std::min(row + 2, rows - 1); ++r) {
+        for (int c = std::max(col - 2, 0); c <= std::min(col + 2, columns - 1); ++c) {
+            int b = r * columns + c;
+            if (b == a || !hiddenMask[b]) continue;
+
+            std::uint64_t windowB = spread(hiddenMask[b], r - row, c - col);
+            if (!(windowA & windowB)) continue;
+
+            std::uint64_t onlyA = windowA & ~windowB;
+            std::uint64_t onlyB = windowB & ~windowA;
+            int needB = needed[b];
+            int marked = 0;
+            if (needB - needA == popCount(onlyB)) {
+                // B needs so many more mines than A that every cell only B touches is a mine,
+                // which leaves all of A's mines in the shared cells
+                marked = markWindow(a, onlyB, true) + markWindow(a, onlyA, false);
+            } else if (needA - needB == popCount(onlyA)) {
+                marked = markWindow(a, onlyA, true) + markWindow(a, onlyB, false);
+            } else if (needA == needB && !onlyA) {
+                marked = markWindow(a, onlyB, false); // A is a subset of B with the same count
+            } else if (needA == needB && !onlyB) {
+                marked = markWindow(a, onlyA, false);
+            }
+
+            // The masks changed, look at this number again with the new ones
+            if (marked) {
+                enqueue(a);
+                return;
+            }
+        }
+    }
+}
+
+void Solver::propagate() {
+    for (;;) {
+        while (worklistHead < worklist.size()) {
+            int index = worklist[worklistHead++];
+            queued.reset(index);
+            process(index);
+        }
+        worklist.clear();
+        worklistHead = 0;
+
+        // Mine count rule: when the remaining mines are all accounted for, or fill every unknown cell
+        int unknownMines = remainingMines - mineCount;
+        if (unknownCount == 0 || (unknownMines != 0 && unknownMines != unknownCount)) break;
+
+        std::vector<int> cells;
+        unknown.forEach([&cells](int index) { cells.push_back(index); });
+        for (int index : cells) {
+            mark(index, unknownMines != 0);
+        }
+    }
+}
+
+bool playDeductions(GameEngine& engine, Solver& solver) {
+    if (!solver.hasDeductions()) return false;
+
+    // Flag every proven mine and reveal every proven safe cell in one batch, so the engine
+    // evaluates the game once and the solver sees one merged list of changes
+    const Board& board = engine.getBoard();
+    std::vector<GameEngine::Action> actions;
+    for (int index : solver.getMineCells()) {
+        GameEngine::Action action = {GameEngine::ActionType::Flag, board.rowOf(index), board.colOf(index)};
+        actions.push_back(action);
+    }
+    for (int index : solver.getSafeCells()) {
+        // Cells opened by an earlier flood in the batch are skipped by the engine
+        GameEngine::Action action = {GameEngine::ActionType::Reveal, board.rowOf(index), board.colOf(index)};
+        actions.push_back(action);
+    }
+
+    if (engine.apply(actions)) {
+        solver.update(engine, engine.getChangedCells());
+    }
+    return true;
+}
+
+bool solveWithoutGuessing(GameEngine& engine, Solver& solver) {
+    solver.reset(engine);
+    while (!engine.isOver() && playDeductions(engine, solver)) {
+    }
+    return engine.isWon();
+}
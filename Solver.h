@@ -0,0 +1,70 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "BitSet.h"
+#include "GameEngine.h"
+#include <cstdint>
+#include <vector>
+
+// Deterministic logic solver. It only looks at what a player can see: revealed numbers and
+// flags (flags are trusted to be on mines). Hidden mine bits are never read.
+//
+// Every revealed number is a constraint "exactly `needed` of these hidden neighbours are mines",
+// with the hidden neighbours packed into a 9-bit mask. Pair rules compare two numbers up to two
+// cells apart by spreading both masks into a shared 7x7 window (one 64-bit word), so subset and
+// difference checks are a few word operations. Cell states are board-wide bitsets. After the
+// first reset only the numbers around changed cells are re-examined, so a move costs time in
+// proportion to what it changed, not to the size of the board or frontier.
+class Solver {
+public:
+    void reset(const GameEngine& engine);                                        // Re-read the whole board
+    void update(const GameEngine& engine, const std::vector<int>& changedCells); // After a reveal or flag
+
+    // Cells proven safe but still hidden, and proven mines not flagged yet, in the order they were found
+    const std::vector<int>& getSafeCells();
+    const std::vector<int>& getMineCells();
+    bool hasDeductions() const { return safeCount > 0 || mineCount > 0; }
+    bool isUnknown(int index) const { return unknown.test(index); } // Hidden, unflagged and not deduced
+
+    const BitSet& getFrontier() const { return frontier; } // Unknown cells next to a revealed number
+    int getUnknownCount() const { return unknownCount; }   // Hidden cells neither flagged nor deduced
+
+private:
+    BitSet unknown;  // Hidden, not flagged, not deduced
+    BitSet safe;     // Deduced safe, still hidden
+    BitSet mines;    // Deduced mine, not flagged
+    BitSet flagged;  // Flags already accounted for
+    BitSet frontier;
+    BitSet queued;
+    int unknownCount = 0;
+    int safeCount = 0;
+    int mineCount = 0;
+    int remainingMines = 0; // Mines among the unknown cells
+
+    int columns = 0;
+    int rows = 0;
+    std::vector<std::uint16_t> hiddenMask; // Per revealed number: unknown neighbours, bit (dr + 1) * 3 + (dc + 1)
+    std::vector<std::int8_t> needed;       // Per revealed number: mines among those neighbours
+    std::vector<int> worklist;
+    size_t worklistHead = 0;
+    std::vector<int> safeCells;
+    std::vector<int> mineCells;
+
+    void addConstraint(int index, int adjacentMines); // A number was revealed
+    void known(int index, bool isMine);      // An unknown cell became known, update the numbers around it
+    bool mark(int index, bool isMine);       // Record a deduction
+    int markWindow(int center, std::uint64_t window, bool isMine);
+    void enqueue(int index);
+    void process(int index);                 // Apply the single and pair rules to one number
+    void propagate();                        // Run until nothing new can be deduced
+};
+
+// Flags every proven mine and reveals every proven safe cell, keeping the solver up to date.
+// Returns false if there was nothing to play.
+bool playDeductions(GameEngine& engine, Solver& solver);
+
+// Plays only moves the solver can prove, until it is stuck or the game is over.
+// Returns true if the game was won without a guess.
+bool solveWithoutGuessing(GameEngine& engine, Solver& solver);
+
+#endif // SOLVER_H
@@ -0,0 +1,75 @@
+#include "Strategy.h"
+
+void RandomStrategy::newGame(const GameEngine& engine, std::uint64_t seed) {
+    (void)engine;
+    random = Random(seed);
+}
+
+int RandomStrategy::randomHiddenCell(const GameEngine& engine, const Solver* solver) {
+    const Board& board = engine.getBoard();
+
+    // The first click goes in the middle, where the safe generation modes open up the most
+    if (engine.getRevealedSafeCount() == 0 && engine.getFlagCount() == 0) {
+        return board.index(board.getRows() / 2, board.getColumns() / 2);
+    }
+
+    // Sample until a hidden cell comes up; fall back to a scan once most of the board is open
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        int index = static_cast<int>(random.below(static_cast<std::uint32_t>(board.size())));
+        Cell cell = board[index];
+        if (cell.isRevealed() || cell.isFlagged()) continue;
+        if (solver && !solver->isUnknown(index)) continue;
+        return index;
+    }
+
+    std::vector<int> candidates;
+    for (int index = 0; index < board.size(); ++index) {
+        Cell cell = board[index];
+        if (cell.isRevealed() || cell.isFlagged()) continue;
+        if (solver && !solver->isUnknown(index)) continue;
+        candidates.push_back(index);
+    }
+    return candidates.empty() ? -1 : candidates[random.below(static_cast<std::uint32_t>(candidates.size()))];
+}
+
+Strategy::Move RandomStrategy::nextMove(const GameEngine& engine) {
+    Move move = {randomHiddenCell(engine, nullptr), false};
+    return move;
+}
+
+void LogicStrategy::newGame(const GameEngine& engine, std::uint64_t seed) {
+    RandomStrategy::newGame(engine, seed);
+    solver.reset(engine);
+}
+
+void LogicStrategy::moved(const GameEngine& engine) {
+    solver.update(engine, engine.getChangedCells());
+}
+
+Strategy::Move LogicStrategy::nextMove(const GameEngine& engine) {
+    const std::vector<int>& safeCells = solver.getSafeCells();
+    Move move = {safeCells.empty() ? guess(engine) : safeCells.front(), false};
+    return move;
+}
+
+int LogicStrategy::guess(const GameEngine& engine) {
+    return randomHiddenCell(engine, &solver);
+}
+
+int ProbabilityStrategy::guess(const GameEngine& engine) {
+    if (engine.getRevealedSafeCount() == 0 || !probabilities.compute(engine)) {
+        return LogicStrategy::guess(engine);
+    }
+    return probabilities.getSafestCell();
+}
+
+std::vector<std::string> strategyNames() {
+    return {"random", "logic", "probability"};
+}
+
+std::unique_ptr<Strategy> createStrategy(const std::string& name) {
+    if (name == "random") return std::unique_ptr<Strategy>(new RandomStrategy());
+    if (name == "logic") return std::unique_ptr<Strategy>(new LogicStrategy());
+    if (name == "probability") return std::unique_ptr<Strategy>(new ProbabilityStrategy());
+    return nullptr;
+}
@@ -0,0 +1,70 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "GameEngine.h"
+#include "ProbabilityEngine.h"
+#include "Random.h"
+#include "Solver.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A player for headless games. The driver asks for a move, applies it to the engine and then
+// calls moved(), so strategies can follow the changed cells instead of rescanning the board.
+// Strategies only look at the visible state.
+class Strategy {
+public:
+    struct Move {
+        int index;
+        bool flag; // Toggle a flag instead of revealing
+    };
+
+    virtual ~Strategy() {}
+    virtual const char* getName() const = 0;
+    virtual void newGame(const GameEngine& engine, std::uint64_t seed) = 0; // Seed for any random choices
+    virtual Move nextMove(const GameEngine& engine) = 0;
+    virtual void moved(const GameEngine& engine) { (void)engine; }
+};
+
+// Reveals random hidden cells, starting in the middle of the board
+class RandomStrategy : public Strategy {
+public:
+    const char* getName() const override { return "random"; }
+    void newGame(const GameEngine& engine, std::uint64_t seed) override;
+    Move nextMove(const GameEngine& engine) override;
+
+protected:
+    Random random{0};
+    int randomHiddenCell(const GameEngine& engine, const Solver* solver); // Avoids proven mines if a solver is given
+};
+
+// Plays every move the logic solver can prove, guesses a random cell when stuck. Proven mines
+// are never flagged (no clicks are spent on them), only avoided.
+class LogicStrategy : public RandomStrategy {
+public:
+    const char* getName() const override { return "logic"; }
+    void newGame(const GameEngine& engine, std::uint64_t seed) override;
+    Move nextMove(const GameEngine& engine) override;
+    void moved(const GameEngine& engine) override;
+
+protected:
+    Solver solver;
+    virtual int guess(const GameEngine& engine);
+};
+
+// Like LogicStrategy, but guesses the cell least likely to be a mine
+class ProbabilityStrategy : public LogicStrategy {
+public:
+    const char* getName() const override { return "probability"; }
+
+protected:
+    ProbabilityEngine probabilities;
+    int guess(const GameEngine& engine) override;
+};
+
+// Names accepted by createStrategy
+std::vector<std::string> strategyNames();
+std::unique_ptr<Strategy> createStrategy(const std::string& name); // nullptr for an unknown name
+
+#endif // STRATEGY_H
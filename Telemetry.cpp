@@ -0,0 +1,125 @@
+#include "Telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+void LatencyHistogram::reset() {
+    std::fill(buckets, buckets + BUCKETS, 0);
+    count = 0;
+    sum = 0.0;
+    minValue = 0.0;
+    maxValue = 0.0;
+}
+
+int LatencyHistogram::bucketOf(double microseconds) {
+    if (microseconds < 1.0) return 0;
+
+    int exponent;
+    double fraction = std::frexp(microseconds, &exponent); // microseconds = fraction * 2^exponent, fraction in [0.5, 1)
+    int octave = exponent - 1;
+    if (octave >= OCTAVES) return BUCKETS - 1;
+
+    int sub = static_cast<int>((fraction * 2.0 - 1.0) * SUB_BUCKETS);
+    return 1 + octave * SUB_BUCKETS + sub;
+}
+
+double LatencyHistogram::upperBound(int bucket) {
+    if (bucket == 0) return 1.0;
+    if (bucket == BUCKETS - 1) return std::ldexp(1.0, OCTAVES);
+
+    int octave = (bucket - 1) / SUB_BUCKETS;
+    int sub = (bucket - 1) % SUB_BUCKETS;
+    return std::ldexp(1.0 + (sub + 1.0) / SUB_BUCKETS, octave);
+}
+
+void LatencyHistogram::record(double microseconds) {
+    ++buckets[bucketOf(microseconds)];
+    minValue = count == 0 ? microseconds : std::min(minValue, microseconds);
+    maxValue = std::max(maxValue, microseconds);
+    sum += microseconds;
+    ++count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count == 0) return;
+    for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+        buckets[bucket] += other.buckets[bucket];
+    }
+    minValue = count == 0 ? other.minValue : std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+    count += other.count;
+}
+
+double LatencyHistogram::getPercentile(double percentile) const {
+    if (count == 0) return 0.0;
+
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count));
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= target && seen > 0) {
+            return std::min(upperBound(bucket), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+void Telemetry::record(Metric metric, Clock::duration duration) {
+    histograms[metric].record(std::chrono::duration<double, std::micro>(duration).count());
+}
+
+const char* Telemetry::getName(Metric metric) {
+    static const char* names[METRIC_COUNT] = {"update", "render", "present", "frame", "input_latency", "reset", "reveal"};
+    return names[metric];
+}
+
+std::string Telemetry::summary() const {
+    std::string text;
+    char line[128];
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        const LatencyHistogram& histogram = histograms[metric];
+        std::snprintf(line, sizeof(line), "%-13s p50 %8.0fus  p99 %8.0fus  n=%llu\n",
+                      getName(static_cast<Metric>(metric)), histogram.getPercentile(50), histogram.getPercentile(99),
+                      static_cast<unsigned long long>(histogram.getCount()));
+        text += line;
+    }
+    return text;
+}
+
+bool Telemetry::writeCsv(const std::string& file) const {
+    std::FILE* output = std::fopen(file.c_str(), "w");
+    if (!output) return false;
+
+    std::fprintf(output, "metric,count,mean_us,min_us,p50_us,p90_us,p99_us,max_us\n");
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        const LatencyHistogram& h = histograms[metric];
+        std::fprintf(output, "%s,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", getName(static_cast<Metric>(metric)),
+                     static_cast<unsigned long long>(h.getCount()), h.getMean(), h.getMin(),
+                     h.getPercentile(50), h.getPercentile(90), h.getPercentile(99), h.getMax());
+    }
+    return std::fclose(output) == 0;
+}
+
+bool Telemetry::writeJson(const std::string& file) const {
+    std::FILE* output = std::fopen(file.c_str(), "w");
+    if (!output) return false;
+
+    std::fprintf(output, "{\n");
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        const LatencyHistogram& h = histograms[metric];
+        std::fprintf(output,
+                     "  \"%s\": {\"count\": %llu, \"mean_us\": %.1f, \"min_us\": %.1f, \"p50_us\": %.1f, "
+                     "\"p90_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}%s\n",
+                     getName(static_cast<Metric>(metric)), static_cast<unsigned long long>(h.getCount()),
+                     h.getMean(), h.getMin(), h.getPercentile(50), h.getPercentile(90), h.getPercentile(99),
+                     h.getMax(), metric + 1 < METRIC_COUNT ? "," : "");
+    }
+    std::fprintf(output, "}\n");
+    return std::fclose(output) == 0;
+}
+
+bool Telemetry::write(const std::string& file) const {
+    bool csv = file.size() >= 4 && file.compare(file.size() - 4, 4, ".csv") == 0;
+    return csv ? writeCsv(file) : writeJson(file);
+}
@@ -0,0 +1,81 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Fixed-size latency histogram. Buckets are log-spaced (four per power of two of
+// microseconds, from 1us to about 16s), so recording never allocates.
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(double microseconds);
+    void reset();
+    void merge(const LatencyHistogram& other); // Add another histogram's samples, e.g. from another thread
+
+    std::uint64_t getCount() const { return count; }
+    double getMean() const { return count ? sum / count : 0.0; }
+    double getMin() const { return count ? minValue : 0.0; }
+    double getMax() const { return maxValue; }
+    double getPercentile(double percentile) const; // Upper bound of the bucket holding the percentile
+
+private:
+    static const int SUB_BUCKETS = 4;
+    static const int OCTAVES = 24;
+    static const int BUCKETS = OCTAVES * SUB_BUCKETS + 2; // Plus underflow (<1us) and overflow
+
+    std::uint64_t buckets[BUCKETS];
+    std::uint64_t count;
+    double sum;
+    double minValue;
+    double maxValue;
+
+    static int bucketOf(double microseconds);
+    static double upperBound(int bucket);
+};
+
+// Named timing histograms for the game loop
+class Telemetry {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    enum Metric {
+        UPDATE,        // Event handling and state updates of one frame
+        RENDER,        // Building and submitting draw calls
+        PRESENT,       // window.display()
+        FRAME,         // Update + render + present
+        INPUT_LATENCY, // Input event received to the frame that shows it on screen
+        RESET,         // resetGame()
+        REVEAL,        // One reveal, including flood fills
+        METRIC_COUNT
+    };
+
+    void record(Metric metric, Clock::duration duration);
+    const LatencyHistogram& get(Metric metric) const { return histograms[metric]; }
+    static const char* getName(Metric metric);
+
+    std::string summary() const;                // A few lines for the on-screen overlay
+    bool writeCsv(const std::string& file) const;
+    bool writeJson(const std::string& file) const;
+    bool write(const std::string& file) const;  // CSV or JSON depending on the file extension
+
+private:
+    LatencyHistogram histograms[METRIC_COUNT];
+};
+
+// Records the lifetime of the scope into a metric
+class ScopedTimer {
+public:
+    ScopedTimer(Telemetry& telemetry, Telemetry::Metric metric)
+        : telemetry(telemetry), metric(metric), start(Telemetry::Clock::now()) {}
+    ~ScopedTimer() { telemetry.record(metric, Telemetry::Clock::now() - start); }
+
+private:
+    Telemetry& telemetry;
+    Telemetry::Metric metric;
+    Telemetry::Clock::time_point start;
+};
+
+#endif // TELEMETRY_H
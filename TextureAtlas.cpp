@@ -0,0 +1,78 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+const unsigned ATLAS_PADDING = 1; // Empty pixels between images
+
+bool TextureAtlas::addImage(const std::string& name, const std::string& file) {
+    Entry entry;
+    entry.name = name;
+    if (!entry.image.loadFromFile(file)) {
+        std::cerr << "Failed to load atlas image: " << file << "\n";
+        return false;
+    }
+    pending.push_back(entry);
+    return true;
+}
+
+// Shelf packing: images go left to right in rows, tallest first, a new row starts when one is full
+bool TextureAtlas::pack(unsigned width, std::vector<sf::IntRect>& placed, unsigned& height) const {
+    std::vector<size_t> order(pending.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return pending[a].image.getSize().y > pending[b].image.getSize().y;
+    });
+
+    placed.assign(pending.size(), sf::IntRect());
+    unsigned x = 0, y = 0, rowHeight = 0;
+    for (size_t i : order) {
+        sf::Vector2u size = pending[i].image.getSize();
+        if (size.x > width) return false;
+
+        if (x + size.x > width) {
+            // Start a new row
+            x = 0;
+            y += rowHeight + ATLAS_PADDING;
+            rowHeight = 0;
+        }
+        placed[i] = sf::IntRect(x, y, size.x, size.y);
+        x += size.x + ATLAS_PADDING;
+        rowHeight = std::max(rowHeight, size.y);
+    }
+    height = y + rowHeight;
+    return true;
+}
+
+bool TextureAtlas::build() {
+    // Find the narrowest power of two width whose packing is not taller than it is wide
+    unsigned maxSize = sf::Texture::getMaximumSize();
+    std::vector<sf::IntRect> placed;
+    unsigned width = 64, height = 0;
+    while (!pack(width, placed, height) || height > width) {
+        width *= 2;
+        if (width > maxSize) {
+            std::cerr << "Texture atlas does not fit in a " << maxSize << "px texture\n";
+            return false;
+        }
+    }
+
+    sf::Image atlasImage;
+    atlasImage.create(width, height, sf::Color::Transparent);
+    for (size_t i = 0; i < pending.size(); ++i) {
+        atlasImage.copy(pending[i].image, placed[i].left, placed[i].top);
+        rects[pending[i].name] = placed[i];
+    }
+
+    // One GPU allocation for every image
+    if (!texture.loadFromImage(atlasImage)) {
+        std::cerr << "Failed to create texture atlas\n";
+        return false;
+    }
+    pending.clear();
+    return true;
+}
+
+sf::IntRect TextureAtlas::getRect(const std::string& name) const {
+    std::map<std::string, sf::IntRect>::const_iterator it = rects.find(name);
+    return it != rects.end() ? it->second : sf::IntRect();
+}
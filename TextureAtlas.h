@@ -0,0 +1,32 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+// Packs many small images into one texture at load time and hands out the
+// sub-rectangle of each image, so sprites and vertex arrays can share one texture.
+class TextureAtlas {
+public:
+    bool addImage(const std::string& name, const std::string& file); // Queue an image for packing
+    bool build();                                                     // Pack the queued images into the texture
+
+    const sf::Texture& getTexture() const { return texture; }
+    sf::IntRect getRect(const std::string& name) const; // Empty rect if the name is unknown
+
+private:
+    struct Entry {
+        std::string name;
+        sf::Image image;
+    };
+
+    sf::Texture texture;
+    std::vector<Entry> pending;             // Images waiting for build()
+    std::map<std::string, sf::IntRect> rects;
+
+    bool pack(unsigned width, std::vector<sf::IntRect>& placed, unsigned& height) const;
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker has its own task queue: it takes work from the back
+// of its own queue and, once that is empty, steals from the front of the others, so workers
+// only contend when one of them runs dry. Tasks get the index of the worker running them,
+// which lets callers keep per-worker state without any locking.
+class ThreadPool {
+public:
+    typedef std::function<void(unsigned worker)> Task;
+
+    explicit ThreadPool(unsigned threads = 0); // 0 uses every hardware thread
+    ~ThreadPool();
+
+    void submit(Task task); // Spread round-robin over the worker queues
+    void wait();            // Block until every submitted task has finished
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued;   // Submitted, not started
+    std::atomic<size_t> pending;  // Submitted, not finished
+    std::atomic<unsigned> nextQueue;
+    bool stopping = false;
+
+    // Idle workers and wait() sleep here
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    bool take(unsigned worker, Task& task); // Own queue first, then steal
+    void workerLoop(unsigned worker);
+};
+
+#endif // THREAD_POOL_H
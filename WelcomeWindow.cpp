@@ -49,50 +49,59 @@ void WelcomeWindow::centerText(sf::Text& text, float x, float y) {
 bool WelcomeWindow::run(std::string& playerName) {
     bool launchGame = false;
 
+    bool needsRedraw = true;
     while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-                return false; // Prevent launching the game
-            } else if (event.type == sf::Event::TextEntered) {
-                char enteredChar = static_cast<char>(event.text.unicode);
-                if (std::isalpha(enteredChar) && playerName.size() < 10) {
-                    if (playerName.empty()) enteredChar = std::toupper(enteredChar);
-                    else enteredChar = std::tolower(enteredChar);
-                    playerName += enteredChar;
-                }
-            } else if (event.type == sf::Event::KeyPressed) {
-                if (event.key.code == sf::Keyboard::BackSpace && !playerName.empty()) {
-                    playerName.pop_back();
-                }
-                if (event.key.code == sf::Keyboard::Enter && !playerName.empty()) {
-                    launchGame = true;
-                    window.close();
-                }
-            }
-        }
+        if (needsRedraw) {
+            // Update name text and dynamically center it
+            nameText.setString(playerName);
+            centerText(nameText, 400, 300);
+
+            // Get updated local bounds of nameText
+            sf::FloatRect nameBounds = nameText.getLocalBounds();
 
-        // Update name text and dynamically center it
-        nameText.setString(playerName);
-        centerText(nameText, 400, 300);
+            // Calculate the right edge of nameText
+            float nameTextRightEdge = nameText.getPosition().x + (nameBounds.width / 2.0f);
 
-        // Get updated local bounds of nameText
-        sf::FloatRect nameBounds = nameText.getLocalBounds();
+            // Position the cursor at the end of the nameText
+            cursor.setPosition(nameTextRightEdge + 5, nameText.getPosition().y);
 
-        // Calculate the right edge of nameText
-        float nameTextRightEdge = nameText.getPosition().x + (nameBounds.width / 2.0f);
+            // Draw window
+            window.clear(sf::Color::Blue);
+            window.draw(title);
+            window.draw(prompt);
+            window.draw(nameText);
+            window.draw(cursor);
+            window.display();
+            needsRedraw = false;
+        }
 
-        // Position the cursor at the end of the nameText
-        cursor.setPosition(nameTextRightEdge + 5, nameText.getPosition().y);
+        // Block until the next event, the screen only changes when the player types
+        sf::Event event;
+        if (!window.waitEvent(event)) continue;
 
-        // Draw window
-        window.clear(sf::Color::Blue);
-        window.draw(title);
-        window.draw(prompt);
-        window.draw(nameText);
-        window.draw(cursor);
-        window.display();
+        if (event.type == sf::Event::Closed) {
+            window.close();
+            return false; // Prevent launching the game
+        } else if (event.type == sf::Event::TextEntered) {
+            char enteredChar = static_cast<char>(event.text.unicode);
+            if (std::isalpha(enteredChar) && playerName.size() < 10) {
+                if (playerName.empty()) enteredChar = std::toupper(enteredChar);
+                else enteredChar = std::tolower(enteredChar);
+                playerName += enteredChar;
+                needsRedraw = true;
+            }
+        } else if (event.type == sf::Event::KeyPressed) {
+            if (event.key.code == sf::Keyboard::BackSpace && !playerName.empty()) {
+                playerName.pop_back();
+                needsRedraw = true;
+            }
+            if (event.key.code == sf::Keyboard::Enter && !playerName.empty()) {
+                launchGame = true;
+                window.close();
+            }
+        } else if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+            needsRedraw = true;
+        }
     }
 
     return launchGame;
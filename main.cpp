@@ -1,16 +1,60 @@
 #include "WelcomeWindow.h"
 #include "GameWindow.h"
+#include "Logger.h"
 
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
     string playerName;
+    string telemetryFile;
+    string replayFile;
+    string saveFile = "files/savegame.mss";
+    GameEngine::Generation generation = GameEngine::Generation::Random;
+
+    // Command line options
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (option == "--telemetry" && i + 1 < argc) {
+            telemetryFile = argv[++i]; // Frame timing dump, .csv or .json
+        } else if (option == "--record" && i + 1 < argc) {
+            replayFile = argv[++i]; // Every finished game is appended here as a replay
+        } else if (option == "--save" && i + 1 < argc) {
+            saveFile = argv[++i]; // Autosave file, the game in it is resumed on the next start
+        } else if (option == "--no-save") {
+            saveFile.clear();
+        } else if (option == "--safe-first-click") {
+            generation = GameEngine::Generation::SafeFirstClick;
+        } else if (option == "--no-guess") {
+            generation = GameEngine::Generation::NoGuess; // Boards solvable by logic alone
+        }
+    }
+
+    // Game messages go to a log file, written by a background thread
+    Logger::instance().start("files/minesweeper.log");
 
     // Initialize the welcome window
     WelcomeWindow welcomeWindow("files/font.ttf");
     if (welcomeWindow.run(playerName)) {
+        // A game left unfinished last time is resumed with its own board size
+        int columns = 25, rows = 16, mines = 5;
+        SnapshotFile snapshot;
+        if (!saveFile.empty() && snapshot.open(saveFile) &&
+            snapshot.getHeader().state == static_cast<uint8_t>(GameEngine::State::Playing)) {
+            columns = snapshot.getHeader().columns;
+            rows = snapshot.getHeader().rows;
+            mines = snapshot.getHeader().mines;
+            generation = snapshot.getGeneration();
+        } else {
+            snapshot.close();
+        }
+
         // Initialize and run the game window
-        GameWindow gameWindow(25, 16, 5, "files/font.ttf", "files/images", playerName);
+        GameWindow gameWindow(columns, rows, mines, "files/font.ttf", "files/images", playerName, generation);
+        gameWindow.setTelemetryOutput(telemetryFile);
+        gameWindow.setReplayOutput(replayFile);
+        gameWindow.setSaveFile(saveFile);
+        gameWindow.resume(snapshot);
+        snapshot.close(); // The engine has its own copy of the board
         gameWindow.run();
     }
 
@@ -0,0 +1,99 @@
+// Behaviour tests for board generation: mine placement, and the vectorized, multithreaded
+// adjacent-count kernel against the scalar reference loop, cell for cell.
+#include "BoardGenerator.h"
+#include "Check.h"
+#include "Random.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static bool sameCells(const Board& a, const Board& b) {
+    return std::equal(a.data(), a.data() + a.size(), b.data(), [](const Cell& x, const Cell& y) { return x.bits == y.bits; });
+}
+
+// Random mines at the given density, plus random revealed and flagged bits the kernel has to keep
+static Board randomBoard(int columns, int rows, double density, std::uint64_t seed) {
+    Board board(columns, rows);
+    Random random(seed);
+    for (int i = 0; i < board.size(); ++i) {
+        if (random.below(1000) < density * 1000) board[i].set(Cell::MINE);
+        if (random.below(4) == 0) board[i].set(Cell::REVEALED);
+        if (random.below(8) == 0) board[i].set(Cell::FLAGGED);
+    }
+    return board;
+}
+
+static void checkKernel(int columns, int rows, double density, std::uint64_t seed, unsigned threads) {
+    Board board = randomBoard(columns, rows, density, seed);
+    Board reference = board;
+    calculateAdjacentMines(board, threads);
+    calculateAdjacentMinesScalar(reference);
+    if (!sameCells(board, reference)) {
+        std::fprintf(stderr, "Counts differ on %dx%d, density %.2f, %u threads\n", columns, rows, density, threads);
+    }
+    CHECK(sameCells(board, reference));
+}
+
+static void testKernelMatchesReference() {
+    // Every width up to a few vector lengths: rows shorter than one vector, exact multiples of
+    // 16 and 32 columns, and every tail length after them
+    const double densities[] = {0.0, 0.2, 0.5, 1.0};
+    for (int columns = 1; columns <= 100; ++columns) {
+        for (int rows = 1; rows <= 4; ++rows) {
+            for (double density : densities) {
+                checkKernel(columns, rows, density, columns * 131 + rows, 1);
+            }
+        }
+    }
+
+    // Row bands on several threads, with band edges at every row offset and more threads than rows
+    const unsigned threads[] = {2, 3, 7, 16};
+    for (unsigned count : threads) {
+        checkKernel(257, 61, 0.2, count, count);
+        checkKernel(33, 5, 0.5, count + 100, count);
+        checkKernel(1, 9, 0.5, count + 200, count);
+    }
+
+    // Large enough to take the automatic multithreaded path
+    checkKernel(1031, 1021, 0.15, 5, 0);
+}
+
+static void testPlaceMines() {
+    for (std::uint64_t seed = 1; seed <= 50; ++seed) {
+        // The 3x3 area around (5, 5) on a 16x16 board stays free
+        std::vector<int> excluded;
+        for (int r = 4; r <= 6; ++r) {
+            for (int c = 4; c <= 6; ++c) excluded.push_back(r * 16 + c);
+        }
+        Board board(16, 16);
+        std::vector<int> positions;
+        placeMines(board, 200, seed, positions, excluded);
+
+        CHECK(positions.size() == 200);
+        int mines = 0;
+        for (int i = 0; i < board.size(); ++i) {
+            if (board[i].isMine()) ++mines;
+        }
+        CHECK(mines == 200);
+        for (int cell : excluded) CHECK(!board[cell].isMine());
+
+        // The same seed places the same mines
+        Board again(16, 16);
+        std::vector<int> againPositions;
+        placeMines(again, 200, seed, againPositions, excluded);
+        CHECK(againPositions == positions);
+    }
+
+    // More mines than allowed cells fills every allowed cell
+    Board full(4, 4);
+    std::vector<int> positions;
+    placeMines(full, 100, 1, positions, std::vector<int>(1, 5));
+    CHECK(positions.size() == 15 && !full[5].isMine());
+}
+
+int main() {
+    testKernelMatchesReference();
+    testPlaceMines();
+    std::printf("Board generator tests passed\n");
+    return 0;
+}
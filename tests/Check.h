@@ -0,0 +1,17 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal assertion for the test executables: reports the failed condition and exits non-zero,
+// so ctest marks the test as failed. Unlike assert() it stays active in release builds.
+#define CHECK(condition)                                                                         \
+    do {                                                                                         \
+        if (!(condition)) {                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition);   \
+            std::exit(EXIT_FAILURE);                                                             \
+        }                                                                                        \
+    } while (0)
+
+#endif // CHECK_H
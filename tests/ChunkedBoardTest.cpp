@@ -0,0 +1,116 @@
+// Behaviour tests for the sparse chunked board and the endless engine: chunk keys at the edges
+// of the coordinate range, mines that do not depend on access order, adjacency across chunk
+// edges, state that is only allocated on writes, and capped openings that finish correctly.
+#include "Check.h"
+#include "EndlessEngine.h"
+#include <cstdio>
+
+static int countMines(ChunkedBoard& board, std::int64_t row, std::int64_t col) {
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr || dc) && board.inBounds(row + dr, col + dc) && board.isMine(row + dr, col + dc)) ++count;
+        }
+    }
+    return count;
+}
+
+static void testCoordinateRange() {
+    const std::int64_t limit = ChunkedBoard::COORDINATE_LIMIT;
+    ChunkedBoard board(0, 0, 0.2, 1);
+    CHECK(board.inBounds(limit - 1, -limit));
+    CHECK(!board.inBounds(limit, 0));
+    CHECK(!board.inBounds(0, -limit - 1));
+
+    // The corner chunks of the range and the origin are five different chunks
+    const std::int64_t cells[5][2] = {{0, 0}, {limit - 1, limit - 1}, {-limit, -limit}, {-limit, limit - 1}, {limit - 1, -limit}};
+    for (int i = 0; i < 5; ++i) {
+        board.toggleFlag(cells[i][0], cells[i][1]);
+        for (int j = 0; j < 5; ++j) CHECK(board.isFlagged(cells[j][0], cells[j][1]) == (j <= i));
+    }
+    CHECK(board.getChunkCount() == 5);
+
+    // Neighbours beyond the range are not looked up
+    ChunkedBoard edge(0, 0, 0.2, 1);
+    CHECK(edge.adjacentMines(limit - 1, 0) == countMines(edge, limit - 1, 0));
+    CHECK(edge.getChunkCount() == 2);
+}
+
+static void testMinesAndAdjacency() {
+    // Chunks created in opposite orders hold the same mines
+    ChunkedBoard forward(0, 0, 0.15, 7);
+    ChunkedBoard backward(0, 0, 0.15, 7);
+    for (std::int64_t row = -100; row < 100; ++row) {
+        for (std::int64_t col = -100; col < 100; ++col) forward.isMine(row, col);
+    }
+    for (std::int64_t row = 99; row >= -100; --row) {
+        for (std::int64_t col = 99; col >= -100; --col) {
+            CHECK(forward.isMine(row, col) == backward.isMine(row, col));
+            if (!forward.isMine(row, col)) CHECK(forward.adjacentMines(row, col) == countMines(forward, row, col));
+        }
+    }
+
+    // A bounded board has no mines outside it, so edge cells only count cells inside
+    ChunkedBoard bounded(100, 70, 0.5, 3);
+    CHECK(!bounded.inBounds(70, 0) && !bounded.inBounds(0, -1));
+    for (std::int64_t row = 0; row < 70; ++row) {
+        for (std::int64_t col = 0; col < 100; ++col) {
+            if (!bounded.isMine(row, col)) CHECK(bounded.adjacentMines(row, col) == countMines(bounded, row, col));
+        }
+    }
+}
+
+static void testStateAllocatedOnWrite() {
+    ChunkedBoard board(0, 0, 0.1, 5);
+    for (std::int64_t row = -200; row < 200; row += 3) {
+        for (std::int64_t col = -200; col < 200; col += 3) {
+            board.cellAt(row, col);
+            CHECK(!board.isRevealed(row, col) && !board.isFlagged(row, col));
+        }
+    }
+    CHECK(board.getChunkCount() > 0);
+    CHECK(board.getWrittenChunkCount() == 0);
+    size_t readOnly = board.getMemoryUsage();
+
+    board.setRevealed(0, 0);
+    CHECK(board.getWrittenChunkCount() == 1);
+    CHECK(board.getMemoryUsage() > readOnly);
+    CHECK(board.isRevealed(0, 0) && !board.isRevealed(0, 1));
+}
+
+static void testCappedOpening() {
+    for (std::uint64_t seed = 1; seed <= 20; ++seed) {
+        EndlessEngine engine(0.1, seed, 300, 200);
+        engine.setFloodLimit(50);
+        CHECK(engine.reveal(100, 150));
+        CHECK(!engine.isLost()); // The first click is always safe
+        while (engine.hasPendingOpening()) CHECK(engine.continueOpening());
+
+        // Every revealed zero has all its neighbours revealed, and the score counts the revealed cells
+        ChunkedBoard& board = engine.getBoard();
+        std::uint64_t revealed = 0;
+        for (std::int64_t row = 0; row < 200; ++row) {
+            for (std::int64_t col = 0; col < 300; ++col) {
+                if (!board.isRevealed(row, col)) continue;
+                ++revealed;
+                CHECK(!board.isMine(row, col));
+                if (board.adjacentMines(row, col) != 0) continue;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if (board.inBounds(row + dr, col + dc)) CHECK(board.isRevealed(row + dr, col + dc));
+                    }
+                }
+            }
+        }
+        CHECK(revealed == engine.getRevealedCount());
+    }
+}
+
+int main() {
+    testCoordinateRange();
+    testMinesAndAdjacency();
+    testStateAllocatedOnWrite();
+    testCappedOpening();
+    std::printf("Chunked board tests passed\n");
+    return 0;
+}
@@ -0,0 +1,239 @@
+// Behaviour tests for the game rules: mine placement, flood fill, flags, chording, batches,
+// win/loss and restoring a saved game.
+#include "Check.h"
+#include "GameEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static const int NEIGHBOURS[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+
+static int countMines(const Board& board, int row, int col) {
+    int count = 0;
+    for (const auto& offset : NEIGHBOURS) {
+        int r = row + offset[0], c = col + offset[1];
+        if (board.inBounds(r, c) && board.at(r, c).isMine()) ++count;
+    }
+    return count;
+}
+
+// Cells a reveal of `start` has to open: the start, and every neighbour of each opened zero
+static std::vector<bool> expectedOpening(const Board& board, int start) {
+    std::vector<bool> open(board.size(), false);
+    std::vector<int> queue(1, start);
+    open[start] = true;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int index = queue[i];
+        if (board[index].adjacentMines() != 0) continue;
+        for (const auto& offset : NEIGHBOURS) {
+            int r = board.rowOf(index) + offset[0], c = board.colOf(index) + offset[1];
+            if (!board.inBounds(r, c) || open[board.index(r, c)] || board.at(r, c).isFlagged()) continue;
+            open[board.index(r, c)] = true;
+            queue.push_back(board.index(r, c));
+        }
+    }
+    return open;
+}
+
+static int findCell(const Board& board, bool mine, int adjacentMines) {
+    for (int i = 0; i < board.size(); ++i) {
+        if (board[i].isMine() == mine && !board[i].isRevealed() &&
+            (adjacentMines < 0 || (!mine && board[i].adjacentMines() == adjacentMines))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void testSeededPlacement() {
+    for (std::uint64_t seed = 1; seed <= 50; ++seed) {
+        GameEngine first(30, 16, 99, seed);
+        GameEngine second(30, 16, 99, seed);
+        CHECK(first.getMinePositions() == second.getMinePositions());
+
+        // Exactly `mines` distinct mines, and every count matches its neighbourhood
+        const Board& board = first.getBoard();
+        std::vector<int> positions = first.getMinePositions();
+        std::sort(positions.begin(), positions.end());
+        CHECK(std::unique(positions.begin(), positions.end()) == positions.end());
+        CHECK(positions.size() == 99);
+        int mines = 0;
+        for (int i = 0; i < board.size(); ++i) {
+            if (board[i].isMine()) ++mines;
+            else CHECK(board[i].adjacentMines() == countMines(board, board.rowOf(i), board.colOf(i)));
+        }
+        CHECK(mines == 99);
+    }
+}
+
+static void testFloodFill() {
+    for (std::uint64_t seed = 1; seed <= 200; ++seed) {
+        GameEngine engine(16, 16, 40, seed);
+        const Board& board = engine.getBoard();
+        int start = findCell(board, false, 0);
+        if (start < 0) continue;
+
+        std::vector<bool> expected = expectedOpening(board, start);
+        CHECK(engine.reveal(board.rowOf(start), board.colOf(start)));
+        int opened = 0;
+        for (int i = 0; i < board.size(); ++i) {
+            CHECK(board[i].isRevealed() == expected[i]);
+            if (expected[i]) ++opened;
+        }
+        CHECK(engine.getRevealedSafeCount() == opened);
+        CHECK(static_cast<int>(engine.getChangedCells().size()) == opened);
+
+        // Revealing an open cell again changes nothing
+        CHECK(!engine.reveal(board.rowOf(start), board.colOf(start)));
+    }
+}
+
+static void testFlagsAndCounters() {
+    GameEngine engine(9, 9, 10, 7);
+    const Board& board = engine.getBoard();
+    int mine = findCell(board, true, -1);
+    int safe = findCell(board, false, -1);
+
+    CHECK(engine.toggleFlag(board.rowOf(mine), board.colOf(mine)));
+    CHECK(engine.toggleFlag(board.rowOf(safe), board.colOf(safe)));
+    CHECK(engine.getFlagCount() == 2);
+    CHECK(engine.getCorrectFlagCount() == 1);
+    CHECK(engine.getRemainingMines() == 8);
+
+    // A flagged cell cannot be revealed
+    CHECK(!engine.reveal(board.rowOf(safe), board.colOf(safe)));
+    CHECK(!board[safe].isRevealed());
+
+    CHECK(engine.toggleFlag(board.rowOf(mine), board.colOf(mine)));
+    CHECK(engine.getFlagCount() == 1);
+    CHECK(engine.getCorrectFlagCount() == 0);
+}
+
+static void testWinAndLoss() {
+    GameEngine winner(9, 9, 10, 11);
+    const Board& board = winner.getBoard();
+    for (int i = 0; i < board.size(); ++i) {
+        if (!board[i].isMine()) winner.reveal(board.rowOf(i), board.colOf(i));
+    }
+    CHECK(winner.isWon());
+    CHECK(winner.getRevealedSafeCount() == winner.getSafeCellCount());
+    CHECK(!winner.reveal(0, 0)); // Nothing changes after the game ends
+
+    GameEngine loser(9, 9, 10, 11);
+    int mine = findCell(loser.getBoard(), true, -1);
+    CHECK(loser.reveal(board.rowOf(mine), board.colOf(mine)));
+    CHECK(loser.isLost());
+    for (int index : loser.getMinePositions()) {
+        CHECK(loser.getBoard()[index].isRevealed()); // Every mine is shown
+    }
+}
+
+static void testChord() {
+    int chords = 0;
+    for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+        GameEngine engine(16, 16, 40, seed);
+        const Board& board = engine.getBoard();
+        int number = findCell(board, false, 2);
+        if (number < 0) continue;
+        int row = board.rowOf(number), col = board.colOf(number);
+        engine.reveal(row, col);
+
+        // Not enough flags yet, so the chord does nothing
+        CHECK(!engine.chord(row, col));
+
+        for (const auto& offset : NEIGHBOURS) {
+            int r = row + offset[0], c = col + offset[1];
+            if (board.inBounds(r, c) && board.at(r, c).isMine()) engine.toggleFlag(r, c);
+        }
+        engine.chord(row, col);
+        CHECK(!engine.isLost());
+        for (const auto& offset : NEIGHBOURS) {
+            int r = row + offset[0], c = col + offset[1];
+            if (board.inBounds(r, c)) CHECK(board.at(r, c).isRevealed() || board.at(r, c).isFlagged());
+        }
+        ++chords;
+    }
+    CHECK(chords > 0);
+}
+
+static void testBatchMatchesSequential() {
+    for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+        GameEngine batched(16, 16, 40, seed);
+        GameEngine sequential(16, 16, 40, seed);
+        const Board& board = batched.getBoard();
+
+        // Flag a few mines and reveal a few safe cells, with the game still running afterwards
+        std::vector<GameEngine::Action> actions;
+        for (int i = 0; i < board.size() && actions.size() < 12; i += 7) {
+            GameEngine::ActionType type = board[i].isMine() ? GameEngine::ActionType::Flag : GameEngine::ActionType::Reveal;
+            GameEngine::Action action = {type, board.rowOf(i), board.colOf(i)};
+            actions.push_back(action);
+        }
+        batched.apply(actions);
+        for (const GameEngine::Action& action : actions) {
+            sequential.apply(&action, 1);
+        }
+
+        CHECK(batched.getState() == sequential.getState());
+        CHECK(std::equal(board.data(), board.data() + board.size(), sequential.getBoard().data(),
+                         [](const Cell& a, const Cell& b) { return a.bits == b.bits; }));
+        CHECK(batched.getRevealedSafeCount() == sequential.getRevealedSafeCount());
+        CHECK(batched.getFlagCount() == sequential.getFlagCount());
+
+        // The changed cells of a batch are listed once each
+        std::vector<int> changed = batched.getChangedCells();
+        std::sort(changed.begin(), changed.end());
+        CHECK(std::unique(changed.begin(), changed.end()) == changed.end());
+    }
+}
+
+static void testSafeFirstClick() {
+    for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+        GameEngine engine(9, 9, 30, seed, GameEngine::Generation::SafeFirstClick);
+        CHECK(!engine.isGenerated());
+        CHECK(engine.reveal(0, 0));
+        CHECK(engine.isGenerated());
+        CHECK(!engine.isLost());
+        CHECK(static_cast<int>(engine.getMinePositions().size()) == 30);
+        for (int r = 0; r <= 1; ++r) {
+            for (int c = 0; c <= 1; ++c) CHECK(!engine.cellAt(r, c).isMine());
+        }
+    }
+}
+
+static void testRestore() {
+    GameEngine engine(16, 16, 40, 5, GameEngine::Generation::SafeFirstClick);
+    engine.reveal(8, 8);
+    const Board& board = engine.getBoard();
+    int mine = findCell(board, true, -1);
+    engine.toggleFlag(board.rowOf(mine), board.colOf(mine));
+
+    std::vector<std::int32_t> positions(engine.getMinePositions().begin(), engine.getMinePositions().end());
+    GameEngine::SavedState saved = {engine.getSeed(), engine.getState(), engine.isGenerated(), board.data(),
+                                    positions.data(), static_cast<int>(positions.size()), engine.getFlagCount(),
+                                    engine.getCorrectFlagCount(), engine.getRevealedSafeCount()};
+    GameEngine restored(16, 16, 40, 99, GameEngine::Generation::SafeFirstClick);
+    CHECK(restored.restore(saved));
+    CHECK(std::equal(board.data(), board.data() + board.size(), restored.getBoard().data(),
+                     [](const Cell& a, const Cell& b) { return a.bits == b.bits; }));
+    CHECK(restored.getMinePositions() == engine.getMinePositions());
+    CHECK(restored.getFlagCount() == 1);
+    CHECK(restored.getRevealedSafeCount() == engine.getRevealedSafeCount());
+
+    // A saved game of another mine count does not fit
+    GameEngine other(16, 16, 41, 99);
+    CHECK(!other.restore(saved));
+}
+
+int main() {
+    testSeededPlacement();
+    testFloodFill();
+    testFlagsAndCounters();
+    testWinAndLoss();
+    testChord();
+    testBatchMatchesSequential();
+    testSafeFirstClick();
+    testRestore();
+    std::printf("Engine tests passed\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Behaviour tests for replays: encode/decode round trips, verification by playback, and
+// rejection of damaged records.
+#include "Check.h"
+#include "Random.h"
+#include "Replay.h"
+#include "Solver.h"
+#include <cstdio>
+#include <vector>
+
+// Plays random clicks on hidden cells (and the odd flag) until the game ends, recording each one
+static Replay playRandomGame(std::uint64_t seed, GameEngine::Generation generation) {
+    GameEngine engine(16, 16, 40, seed, generation);
+    Replay replay;
+    replay.begin(engine);
+
+    Random random(seed);
+    std::uint32_t time = 0;
+    while (!engine.isOver()) {
+        int index = static_cast<int>(random.below(engine.getBoard().size()));
+        if (engine.getBoard()[index].isRevealed()) continue;
+        GameEngine::ActionType type = random.below(5) == 0 ? GameEngine::ActionType::Flag : GameEngine::ActionType::Reveal;
+        if (engine.getBoard()[index].isFlagged()) type = GameEngine::ActionType::Flag; // Take it back
+        GameEngine::Action action = {type, index / 16, index % 16};
+        time += random.below(2000);
+        if (engine.apply(&action, 1)) replay.record(time, &action, 1);
+    }
+    replay.finish(engine);
+    return replay;
+}
+
+// Plays like the game window with auto-play on: each click is followed by rounds of every
+// proven move, each round applied and recorded as one batch (flags first, then reveals)
+static Replay playAutoGame(std::uint64_t seed) {
+    GameEngine engine(30, 16, 99, seed, GameEngine::Generation::SafeFirstClick);
+    Solver solver;
+    solver.reset(engine);
+    Replay replay;
+    replay.begin(engine);
+
+    Random random(seed);
+    std::uint32_t time = 0;
+    GameEngine::Action click = {GameEngine::ActionType::Reveal, 8, 15};
+    while (!engine.isOver()) {
+        time += random.below(2000);
+        if (!engine.apply(&click, 1)) continue;
+        replay.record(time, &click, 1);
+        solver.update(engine, engine.getChangedCells());
+
+        while (!engine.isOver() && solver.hasDeductions()) {
+            const Board& board = engine.getBoard();
+            std::vector<GameEngine::Action> actions;
+            for (int index : solver.getMineCells()) {
+                GameEngine::Action action = {GameEngine::ActionType::Flag, board.rowOf(index), board.colOf(index)};
+                actions.push_back(action);
+            }
+            for (int index : solver.getSafeCells()) {
+                GameEngine::Action action = {GameEngine::ActionType::Reveal, board.rowOf(index), board.colOf(index)};
+                actions.push_back(action);
+            }
+            engine.apply(actions);
+            replay.record(time, actions);
+            solver.update(engine, engine.getChangedCells());
+        }
+
+        // Stuck, so guess a cell nothing is known about
+        int index;
+        do {
+            index = static_cast<int>(random.below(engine.getBoard().size()));
+        } while (!engine.isOver() && !solver.isUnknown(index));
+        click.row = engine.getBoard().rowOf(index);
+        click.col = engine.getBoard().colOf(index);
+    }
+    replay.finish(engine);
+    return replay;
+}
+
+// True if playing the events one action at a time (ignoring batches) would not end as recorded
+static bool failsUnbatched(const Replay& replay) {
+    GameEngine engine(replay.getColumns(), replay.getRows(), replay.getMines(), replay.getSeed(), replay.getGeneration());
+    for (const Replay::Event& event : replay.getEvents()) {
+        if (engine.isOver()) return true;
+        GameEngine::Action action = {event.type, event.cell / replay.getColumns(), event.cell % replay.getColumns()};
+        engine.apply(&action, 1);
+    }
+    return engine.getState() != replay.getFinalState() || Replay::boardHash(engine.getBoard()) != replay.getFinalHash();
+}
+
+// Auto-play rounds keep their leftover no-op moves after the winning reveal, which only
+// replay correctly as whole batches
+static void testAutoPlayRoundTrip() {
+    int won = 0, needBatches = 0;
+    for (std::uint64_t seed = 1; seed <= 300; ++seed) {
+        Replay replay = playAutoGame(seed);
+        std::vector<std::uint8_t> bytes;
+        replay.encode(bytes);
+        Replay decoded;
+        size_t position = 0;
+        CHECK(decoded.decode(bytes.data(), bytes.size(), position));
+        CHECK(decoded.verify());
+
+        if (decoded.getFinalState() == GameEngine::State::Won) ++won;
+        if (failsUnbatched(decoded)) ++needBatches;
+    }
+    CHECK(won > 0);
+    CHECK(needBatches > 0); // The games above do include the case batches are needed for
+}
+
+// Records written before batches were stored still decode, as one action per batch
+static void testVersionOneRecord() {
+    GameEngine engine(9, 9, 10, 77);
+    int cell = 0;
+    while (engine.getBoard()[cell].isMine()) ++cell;
+    CHECK(cell < 16); // Keeps the hand-encoded event below to one byte
+    GameEngine::Action action = {GameEngine::ActionType::Reveal, cell / 9, cell % 9};
+    engine.apply(&action, 1);
+    std::uint64_t hash = Replay::boardHash(engine.getBoard());
+
+    std::vector<std::uint8_t> bytes = {'M', 'S', 'R', 1, 9, 9, 10, 0, 77, 0, 0, 0, 0, 0, 0, 0, 1, 5};
+    bytes.push_back(static_cast<std::uint8_t>(cell * 2 << 2)); // zigzag(cell) << 2 | Reveal, one byte for cell < 16
+    bytes.push_back(static_cast<std::uint8_t>(engine.getState()));
+    for (int i = 0; i < 8; ++i) bytes.push_back(static_cast<std::uint8_t>(hash >> (i * 8)));
+
+    Replay replay;
+    size_t position = 0;
+    CHECK(replay.decode(bytes.data(), bytes.size(), position));
+    CHECK(replay.getEvents().size() == 1);
+    CHECK(replay.getEvents()[0].cell == cell && !replay.getEvents()[0].batched);
+    CHECK(replay.getDuration() == 5);
+    CHECK(replay.verify());
+}
+
+static void testRoundTrip() {
+    const GameEngine::Generation generations[] = {GameEngine::Generation::Random,
+                                                  GameEngine::Generation::SafeFirstClick};
+    for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+        Replay replay = playRandomGame(seed, generations[seed % 2]);
+        CHECK(replay.getFinalState() != GameEngine::State::Playing);
+        CHECK(replay.verify());
+
+        std::vector<std::uint8_t> bytes;
+        replay.encode(bytes);
+        Replay decoded;
+        size_t position = 0;
+        CHECK(decoded.decode(bytes.data(), bytes.size(), position));
+        CHECK(position == bytes.size());
+        CHECK(decoded.getColumns() == replay.getColumns() && decoded.getRows() == replay.getRows());
+        CHECK(decoded.getMines() == replay.getMines() && decoded.getSeed() == replay.getSeed());
+        CHECK(decoded.getGeneration() == replay.getGeneration());
+        CHECK(decoded.getFinalState() == replay.getFinalState() && decoded.getFinalHash() == replay.getFinalHash());
+        CHECK(decoded.getEvents().size() == replay.getEvents().size());
+        for (size_t i = 0; i < replay.getEvents().size(); ++i) {
+            const Replay::Event& a = replay.getEvents()[i];
+            const Replay::Event& b = decoded.getEvents()[i];
+            CHECK(a.time == b.time && a.type == b.type && a.cell == b.cell && a.batched == b.batched);
+        }
+        CHECK(decoded.verify());
+    }
+}
+
+static void testDamagedRecords() {
+    Replay replay = playRandomGame(42, GameEngine::Generation::Random);
+    std::vector<std::uint8_t> bytes;
+    replay.encode(bytes);
+
+    // Every truncation is rejected
+    for (size_t length = 0; length < bytes.size(); ++length) {
+        Replay decoded;
+        size_t position = 0;
+        CHECK(!decoded.decode(bytes.data(), length, position));
+    }
+
+    // A changed board hash decodes, but no longer verifies
+    std::vector<std::uint8_t> corrupt = bytes;
+    corrupt.back() ^= 0x01;
+    Replay decoded;
+    size_t position = 0;
+    CHECK(decoded.decode(corrupt.data(), corrupt.size(), position));
+    CHECK(!decoded.verify());
+}
+
+static void testAppendAndLoad() {
+    const char* file = "replay_test.msr";
+    std::remove(file);
+    for (std::uint64_t seed = 1; seed <= 10; ++seed) {
+        CHECK(playRandomGame(seed, GameEngine::Generation::Random).append(file));
+    }
+    std::vector<Replay> replays;
+    CHECK(Replay::load(file, replays));
+    CHECK(replays.size() == 10);
+    for (const Replay& replay : replays) CHECK(replay.verify());
+    std::remove(file);
+}
+
+int main() {
+    testRoundTrip();
+    testAutoPlayRoundTrip();
+    testVersionOneRecord();
+    testDamagedRecords();
+    testAppendAndLoad();
+    std::printf("Replay tests passed\n");
+    return 0;
+}
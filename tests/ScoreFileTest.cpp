@@ -0,0 +1,115 @@
+// Behaviour tests for the leaderboard file parser: well-formed "MM:SS,Name" lines, Windows line
+// endings, blank lines, a missing final line break, and malformed or out-of-range lines, which
+// have to be skipped and counted.
+#include "Check.h"
+#include "ScoreFile.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char* SCORE_FILE = "score_file_test.txt";
+
+static bool parses(const char* line, ScoreFile::Record& record) {
+    return ScoreFile::parseLine(line, line + std::strlen(line), record);
+}
+
+static bool parses(const char* line) {
+    ScoreFile::Record record;
+    return parses(line, record);
+}
+
+static std::string nameOf(const ScoreFile::Record& record) {
+    return std::string(record.name, record.nameLength);
+}
+
+// Writes `text` as the whole file and parses it
+static std::vector<ScoreFile::Record> parseFile(ScoreFile& scores, const std::string& text) {
+    std::FILE* output = std::fopen(SCORE_FILE, "wb");
+    CHECK(output != nullptr);
+    CHECK(std::fwrite(text.data(), 1, text.size(), output) == text.size());
+    std::fclose(output);
+
+    std::vector<ScoreFile::Record> records;
+    CHECK(scores.open(SCORE_FILE));
+    CHECK(scores.parse(records) == records.size());
+    return records;
+}
+
+static void testLines() {
+    ScoreFile::Record record;
+    CHECK(parses("01:05,ann", record));
+    CHECK(record.time == 65 && nameOf(record) == "ann");
+    CHECK(parses("123:04,bob", record)); // Minutes are not limited to two digits
+    CHECK(record.time == 123 * 60 + 4);
+    CHECK(parses("00:00,a,b c", record)); // Everything after the first comma is the name
+    CHECK(record.time == 0 && nameOf(record) == "a,b c");
+    CHECK(parses("02:00,cy\r", record)); // A Windows line ending is not part of the name
+    CHECK(nameOf(record) == "cy");
+
+    // Seconds are exactly two digits below 60, and a name is required
+    const char* malformed[] = {"01:60,x", "1:5,x", "01:005,x", "-1:00,x", ":30,x", "01:30", "01:30,", "01:30,\r",
+                               "ab:cd,x", "01-30,x", " 01:30,x", "01:3a,x", "", "\r"};
+    for (const char* line : malformed) {
+        if (parses(line)) std::fprintf(stderr, "Parsed a malformed line: \"%s\"\n", line);
+        CHECK(!parses(line));
+    }
+}
+
+static void testDigitOverflow() {
+    // Minutes are read without overflowing, absurdly long numbers are rejected
+    ScoreFile::Record record;
+    CHECK(parses("1000000:00,big", record));
+    CHECK(record.time == 60000000);
+    CHECK(!parses("100000000:00,x"));
+    CHECK(!parses("99999999999999999999:00,x"));
+    CHECK(!parses("4294967296:00,x"));
+}
+
+static void testFiles() {
+    ScoreFile scores;
+
+    // Blank lines are skipped without counting them as malformed, in either line ending
+    std::vector<ScoreFile::Record> records =
+        parseFile(scores, "01:00,ann\r\n\r\n02:00,bob\n\n\n03:00,cy\r\nbroken\r\n61:99,dee\n04:00,eve");
+    CHECK(records.size() == 4);
+    CHECK(scores.getMalformedCount() == 2);
+    const char* names[] = {"ann", "bob", "cy", "eve"};
+    for (size_t i = 0; i < records.size(); ++i) {
+        CHECK(nameOf(records[i]) == names[i]);
+    }
+    CHECK(records[3].time == 240); // The last line has no line break
+    scores.close();
+
+    // A last line cut short is malformed
+    records = parseFile(scores, "01:00,ann\n02:0");
+    CHECK(records.size() == 1 && scores.getMalformedCount() == 1);
+    scores.close();
+
+    // Empty files and files of only blank lines hold nothing
+    records = parseFile(scores, "");
+    CHECK(records.empty() && scores.getMalformedCount() == 0);
+    scores.close();
+    records = parseFile(scores, "\n\r\n\n");
+    CHECK(records.empty() && scores.getMalformedCount() == 0);
+    scores.close();
+
+    // The count is of the last parse only
+    records = parseFile(scores, "x\ny\n");
+    CHECK(records.empty() && scores.getMalformedCount() == 2);
+    scores.close();
+    records = parseFile(scores, "05:00,zed\n");
+    CHECK(records.size() == 1 && scores.getMalformedCount() == 0);
+    scores.close();
+
+    CHECK(!scores.open("score_file_test_missing.txt"));
+    std::remove(SCORE_FILE);
+}
+
+int main() {
+    testLines();
+    testDigitOverflow();
+    testFiles();
+    std::printf("Score file tests passed\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Behaviour tests for the score store: rank, percentile and personal-best queries checked against
+// a brute-force reference, before and after compaction and reloading, plus recovery from torn
+// and damaged log lines. Also covers the Fenwick tree the rank queries are built on.
+#include "Check.h"
+#include "FenwickTree.h"
+#include "Random.h"
+#include "ScoreStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+static const char* LOG_FILE = "score_store_test.log";
+
+struct Score {
+    int time;
+    std::string name;
+};
+
+static void testFenwickTree() {
+    Random random(3);
+    FenwickTree tree;
+    std::vector<std::uint64_t> counts(5000, 0);
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(random.below(i < 100 ? 10 : 5000)); // Starts small, so the tree has to grow
+        tree.add(key, 1);
+        ++counts[key];
+    }
+
+    std::uint64_t sum = 0;
+    for (int key = 0; key < 5000; ++key) {
+        sum += counts[key];
+        CHECK(tree.prefix(key) == sum);
+        CHECK(tree.get(key) == counts[key]);
+        if (counts[key] > 0) CHECK(tree.findKth(sum) == key); // The last element at this key
+    }
+    CHECK(tree.getTotal() == 20000);
+    CHECK(tree.findKth(0) == tree.size());
+    CHECK(tree.findKth(20001) == tree.size());
+}
+
+// Compares every query with the same numbers computed from the full list of scores
+static void checkAgainst(const ScoreStore& store, const ScoreStore::Key& key, const std::vector<Score>& scores) {
+    CHECK(store.getScoreCount(key) == scores.size());
+
+    std::map<std::string, int> bests;
+    for (const Score& score : scores) {
+        auto best = bests.find(score.name);
+        if (best == bests.end() || score.time < best->second) bests[score.name] = score.time;
+    }
+    CHECK(store.getPlayerCount(key) == bests.size());
+
+    for (int time = 0; time <= 130; time += 13) {
+        std::uint64_t faster = 0, notSlower = 0, between = 0;
+        for (const Score& score : scores) {
+            if (score.time < time) ++faster;
+            if (score.time <= time) ++notSlower;
+            if (score.time >= time && score.time <= time + 20) ++between;
+        }
+        CHECK(store.getRank(key, time) == faster + 1);
+        CHECK(store.getPercentile(key, time) == 100.0 * notSlower / scores.size());
+        CHECK(store.countBetween(key, time, time + 20) == between);
+    }
+
+    // Players ranked by personal best, ties in the order the bests were set
+    std::vector<ScoreStore::Entry> page = store.playerPage(key, 0, bests.size());
+    CHECK(page.size() == bests.size());
+    for (size_t i = 0; i < page.size(); ++i) {
+        CHECK(bests[page[i].name] == page[i].time);
+        if (i > 0) CHECK(page[i - 1].time <= page[i].time);
+
+        ScoreStore::Entry best;
+        CHECK(store.getPersonalBest(key, page[i].name, best));
+        CHECK(best.time == page[i].time);
+        std::uint64_t rank = 1;
+        for (const auto& other : bests) {
+            if (other.second < best.time) ++rank;
+        }
+        CHECK(store.getPlayerRank(key, page[i].name) == rank);
+    }
+    for (size_t first = 0; first < page.size(); first += 3) {
+        std::vector<ScoreStore::Entry> part = store.playerPage(key, first, 3);
+        for (size_t i = 0; i < part.size(); ++i) CHECK(part[i].name == page[first + i].name);
+    }
+
+    // The kept top scores are the fastest ones
+    std::vector<int> times;
+    for (const Score& score : scores) times.push_back(score.time);
+    std::sort(times.begin(), times.end());
+    std::vector<ScoreStore::Entry> top = store.top(key, 10);
+    for (size_t i = 0; i < top.size(); ++i) CHECK(top[i].time == times[i]);
+}
+
+static void testQueriesAndCompaction() {
+    std::remove(LOG_FILE);
+    ScoreStore::Key key = {16, 16, 40};
+    ScoreStore::Key otherKey = {30, 16, 99};
+    std::vector<Score> scores;
+    {
+        ScoreStore store(10);
+        CHECK(store.open(LOG_FILE));
+        CHECK(store.isEmpty());
+
+        Random random(9);
+        for (int i = 0; i < 3000; ++i) {
+            Score score = {static_cast<int>(random.below(120)) + 5, "player" + std::to_string(random.below(40))};
+            store.add(key, score.time, score.name);
+            scores.push_back(score);
+            store.add(otherKey, 50, "other"); // Another board never shows up in this one's queries
+        }
+        checkAgainst(store, key, scores);
+
+        // Most scores are neither kept nor a personal best, so the log was compacted along the way
+        CHECK(store.getLogRecordCount() < 2 * 3000);
+        CHECK(store.compact());
+        checkAgainst(store, key, scores);
+    }
+
+    // Reloading the compacted log gives the same answers
+    ScoreStore reloaded(10);
+    CHECK(reloaded.open(LOG_FILE));
+    CHECK(reloaded.getMalformedCount() == 0);
+    checkAgainst(reloaded, key, scores);
+    CHECK(reloaded.getScoreCount(otherKey) == 3000);
+    std::remove(LOG_FILE);
+}
+
+static void testTornLine() {
+    std::remove(LOG_FILE);
+    ScoreStore::Key key = {9, 9, 10};
+    std::vector<Score> scores;
+    {
+        ScoreStore store;
+        CHECK(store.open(LOG_FILE));
+        const char* names[] = {"ann", "bob", "cy"};
+        for (int i = 0; i < 3; ++i) {
+            Score score = {30 + i, names[i]};
+            store.add(key, score.time, score.name);
+            scores.push_back(score);
+        }
+    }
+
+    // A write that stopped halfway through a line
+    std::FILE* log = std::fopen(LOG_FILE, "ab");
+    CHECK(log != nullptr);
+    std::fputs("9,9,10,4", log);
+    std::fclose(log);
+
+    ScoreStore store;
+    CHECK(store.open(LOG_FILE));
+    CHECK(store.getMalformedCount() == 1);
+    checkAgainst(store, key, scores);
+
+    // New scores go on a fresh line after the repair
+    Score score = {12, "dee"};
+    store.add(key, score.time, score.name);
+    scores.push_back(score);
+    store.close();
+    CHECK(store.open(LOG_FILE));
+    CHECK(store.getMalformedCount() == 0);
+    checkAgainst(store, key, scores);
+    store.close();
+    std::remove(LOG_FILE);
+}
+
+static void testDamagedLines() {
+    // Lines cut short in the middle of the log must not take their missing fields from the next line
+    std::FILE* log = std::fopen(LOG_FILE, "wb");
+    CHECK(log != nullptr);
+    std::fputs("9,9,10,30,ann\n9,9,10,\n40,bob\n+9,9,10\n5,3\n9,9,10,50,\n9,9,10,-5,dee\n9,9,10,50,cy\n", log);
+    std::fclose(log);
+
+    ScoreStore::Key key = {9, 9, 10};
+    std::vector<Score> scores;
+    scores.push_back(Score{30, "ann"});
+    scores.push_back(Score{50, "cy"});
+    {
+        ScoreStore store;
+        CHECK(store.open(LOG_FILE));
+        CHECK(store.getMalformedCount() == 6);
+        checkAgainst(store, key, scores);
+    }
+
+    // The damaged lines were dropped by rewriting the log
+    ScoreStore store;
+    CHECK(store.open(LOG_FILE));
+    CHECK(store.getMalformedCount() == 0);
+    checkAgainst(store, key, scores);
+    store.close();
+    std::remove(LOG_FILE);
+}
+
+static void testSlowTimes() {
+    // Anything slower than the timer shows counts as 99:59, and still ranks behind faster games
+    ScoreStore store;
+    ScoreStore::Key key = {9, 9, 10};
+    store.add(key, 40, "ann");
+    store.add(key, 100000000, "bob");
+    ScoreStore::Entry best;
+    CHECK(store.getPersonalBest(key, "bob", best));
+    CHECK(best.time == 99 * 60 + 59);
+    CHECK(store.getPlayerRank(key, "bob") == 2);
+    CHECK(store.getRank(key, 100000000) == 2);
+    CHECK(store.countBetween(key, 0, 100000000) == 2);
+}
+
+static void testUnwritableLog() {
+    // A log in a directory that does not exist cannot be opened, scores then only count in memory
+    ScoreStore store;
+    CHECK(!store.open("missing_directory/scores.log"));
+    CHECK(!store.isSaving());
+    ScoreStore::Key key = {9, 9, 10};
+    store.add(key, 30, "ann");
+    CHECK(store.getScoreCount(key) == 1);
+    CHECK(!store.isSaving());
+
+    std::remove(LOG_FILE);
+    CHECK(store.open(LOG_FILE));
+    CHECK(store.isSaving());
+    store.close();
+    std::remove(LOG_FILE);
+}
+
+int main() {
+    testFenwickTree();
+    testSlowTimes();
+    testQueriesAndCompaction();
+    testTornLine();
+    testDamagedLines();
+    testUnwritableLog();
+    std::printf("Score store tests passed\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Behaviour tests for saved games: snapshots written to disk restore the exact game, and
+// damaged snapshots whose cells disagree with their mine list or counters are refused.
+#include "Check.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static const char* SAVE_FILE = "snapshot_test.mss";
+
+static bool sameBoard(const GameEngine& a, const GameEngine& b) {
+    const Board& first = a.getBoard();
+    return std::equal(first.data(), first.data() + first.size(), b.getBoard().data(),
+                      [](const Cell& x, const Cell& y) { return x.bits == y.bits; });
+}
+
+// A game in progress: an opening, one correct and one wrong flag
+static void playSome(GameEngine& engine) {
+    const Board& board = engine.getBoard();
+    int first = engine.getBoard().index(8, 8);
+    while (engine.isGenerated() && board[first].isMine()) ++first; // The safe modes place mines on this reveal
+    engine.reveal(board.rowOf(first), board.colOf(first));
+    CHECK(!engine.isOver());
+    bool mineFlagged = false, safeFlagged = false;
+    for (int i = 0; i < board.size(); ++i) {
+        if (board[i].isRevealed()) continue;
+        if (board[i].isMine() && !mineFlagged) mineFlagged = engine.toggleFlag(board.rowOf(i), board.colOf(i));
+        if (!board[i].isMine() && !safeFlagged) safeFlagged = engine.toggleFlag(board.rowOf(i), board.colOf(i));
+    }
+}
+
+static void testRoundTrip() {
+    const GameEngine::Generation generations[] = {GameEngine::Generation::Random, GameEngine::Generation::SafeFirstClick};
+    for (GameEngine::Generation generation : generations) {
+        GameEngine engine(16, 16, 40, 21, generation);
+        playSome(engine);
+
+        std::vector<std::uint8_t> bytes;
+        SnapshotWriter::encode(engine, 12345, bytes);
+        CHECK(SnapshotWriter::write(bytes, SAVE_FILE));
+
+        SnapshotFile snapshot;
+        CHECK(snapshot.open(SAVE_FILE));
+        CHECK(snapshot.getHeader().elapsedMilliseconds == 12345);
+        GameEngine restored(16, 16, 40, 1, snapshot.getGeneration());
+        CHECK(restored.restore(snapshot.getSavedState()));
+        CHECK(sameBoard(engine, restored));
+        CHECK(restored.getState() == engine.getState());
+        CHECK(restored.getFlagCount() == 2 && restored.getCorrectFlagCount() == 1);
+        CHECK(restored.getRevealedSafeCount() == engine.getRevealedSafeCount());
+    }
+
+    // A writer on its own thread leaves the latest save on disk
+    GameEngine engine(30, 16, 99, 4);
+    {
+        SnapshotWriter writer;
+        for (int i = 0; i < 5; ++i) writer.save(engine, i, SAVE_FILE);
+        writer.wait();
+    }
+    SnapshotFile snapshot;
+    CHECK(snapshot.open(SAVE_FILE));
+    CHECK(snapshot.getHeader().elapsedMilliseconds == 4);
+    snapshot.close();
+    std::remove(SAVE_FILE);
+}
+
+static void testDamagedCells() {
+    GameEngine engine(16, 16, 40, 33);
+    playSome(engine);
+    const Board& board = engine.getBoard();
+    std::vector<std::int32_t> mines(engine.getMinePositions().begin(), engine.getMinePositions().end());
+    std::vector<Cell> cells(board.data(), board.data() + board.size());
+    GameEngine::SavedState saved = {engine.getSeed(), engine.getState(), engine.isGenerated(), cells.data(),
+                                    mines.data(), static_cast<int>(mines.size()), engine.getFlagCount(),
+                                    engine.getCorrectFlagCount(), engine.getRevealedSafeCount()};
+    GameEngine target(16, 16, 40, 1);
+    std::vector<Cell> before(target.getBoard().data(), target.getBoard().data() + board.size());
+    CHECK(target.restore(saved));
+    target.reset(1);
+
+    int safe = 0;
+    while (board[safe].isMine() || board[safe].isRevealed() || board[safe].isFlagged()) ++safe;
+
+    // An adjacent mine count above 8
+    cells[safe].setAdjacentMines(9);
+    CHECK(!target.restore(saved));
+    cells[safe] = board[safe];
+
+    // A mine bit that is not in the mine list, and one missing from it
+    cells[safe].set(Cell::MINE);
+    CHECK(!target.restore(saved));
+    cells[safe] = board[safe];
+    cells[mines[0]].clear(Cell::MINE);
+    CHECK(!target.restore(saved));
+    cells[mines[0]] = board[mines[0]];
+
+    // Counters that do not match the cells
+    saved.correctFlagCount = 0;
+    CHECK(!target.restore(saved));
+    saved.correctFlagCount = engine.getCorrectFlagCount();
+    saved.revealedSafeCount += 1;
+    CHECK(!target.restore(saved));
+    saved.revealedSafeCount -= 1;
+
+    // A mine listed twice
+    std::int32_t first = mines[1];
+    mines[1] = mines[0];
+    CHECK(!target.restore(saved));
+    mines[1] = first;
+
+    // A state the cells do not support
+    saved.state = GameEngine::State::Won;
+    CHECK(!target.restore(saved));
+    saved.state = GameEngine::State::Playing;
+
+    // The refused snapshots left the engine untouched, and the repaired one is accepted
+    CHECK(std::equal(before.begin(), before.end(), target.getBoard().data(),
+                     [](const Cell& x, const Cell& y) { return x.bits == y.bits; }));
+    CHECK(target.restore(saved));
+    CHECK(sameBoard(engine, target));
+}
+
+int main() {
+    testRoundTrip();
+    testDamagedCells();
+    std::printf("Snapshot tests passed\n");
+    return 0;
+}
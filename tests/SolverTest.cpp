@@ -0,0 +1,97 @@
+// Behaviour tests for the deterministic solver and the probability engine: every deduction has
+// to be right, and the probabilities have to agree with the deductions and the mine count.
+#include "Check.h"
+#include "GameEngine.h"
+#include "ProbabilityEngine.h"
+#include "Solver.h"
+#include <cmath>
+#include <cstdio>
+
+// Every cell the solver proves has to be what it claims, checked against the hidden mine bits
+static void checkDeductions(const GameEngine& engine, Solver& solver) {
+    const Board& board = engine.getBoard();
+    for (int index : solver.getSafeCells()) {
+        CHECK(!board[index].isMine());
+        CHECK(!board[index].isRevealed());
+    }
+    for (int index : solver.getMineCells()) {
+        CHECK(board[index].isMine());
+    }
+}
+
+static void testDeductionsAreSound() {
+    int deduced = 0;
+    for (std::uint64_t seed = 1; seed <= 200; ++seed) {
+        GameEngine engine(16, 16, 40, seed, GameEngine::Generation::SafeFirstClick);
+        Solver solver;
+        solver.reset(engine);
+        engine.reveal(8, 8);
+        solver.update(engine, engine.getChangedCells());
+
+        while (!engine.isOver()) {
+            checkDeductions(engine, solver);
+            if (!solver.hasDeductions()) break;
+            deduced += static_cast<int>(solver.getSafeCells().size() + solver.getMineCells().size());
+            CHECK(playDeductions(engine, solver));
+        }
+        CHECK(!engine.isLost()); // Proven moves never hit a mine
+    }
+    CHECK(deduced > 0);
+}
+
+static void testNoGuessBoardsSolve() {
+    for (std::uint64_t seed = 1; seed <= 5; ++seed) {
+        GameEngine engine(9, 9, 10, seed, GameEngine::Generation::NoGuess);
+        engine.reveal(4, 4);
+        Solver solver;
+        solver.reset(engine);
+        CHECK(solveWithoutGuessing(engine, solver));
+        CHECK(engine.isWon());
+
+        // The search finds the same board on one thread
+        GameEngine single(9, 9, 10, seed, GameEngine::Generation::NoGuess);
+        single.setGeneratorThreads(1);
+        single.reveal(4, 4);
+        CHECK(single.getSeed() == engine.getSeed());
+        CHECK(single.getMinePositions() == engine.getMinePositions());
+    }
+}
+
+static void testProbabilities() {
+    for (std::uint64_t seed = 1; seed <= 50; ++seed) {
+        GameEngine engine(16, 16, 40, seed, GameEngine::Generation::SafeFirstClick);
+        engine.reveal(8, 8);
+        Solver solver;
+        solver.reset(engine);
+        ProbabilityEngine probabilities;
+        CHECK(probabilities.compute(engine));
+
+        const Board& board = engine.getBoard();
+        double expectedMines = 0.0;
+        for (int i = 0; i < board.size(); ++i) {
+            float p = probabilities.getProbability(i);
+            CHECK(p >= 0.0f && p <= 1.0f);
+            if (board[i].isRevealed()) CHECK(p == 0.0f);
+            else expectedMines += p;
+        }
+        // The probabilities of the hidden cells add up to the number of mines left
+        CHECK(std::fabs(expectedMines - engine.getRemainingMines()) < 1e-2);
+
+        // Cells the solver proves are certain here too
+        for (int index : solver.getSafeCells()) CHECK(probabilities.getProbability(index) < 1e-6f);
+        for (int index : solver.getMineCells()) CHECK(probabilities.getProbability(index) > 1.0f - 1e-6f);
+
+        // The safest cell is never a proven mine
+        int safest = probabilities.getSafestCell();
+        CHECK(safest >= 0 && !board[safest].isRevealed());
+        CHECK(probabilities.getProbability(safest) < 1.0f);
+    }
+}
+
+int main() {
+    testDeductionsAreSound();
+    testNoGuessBoardsSolve();
+    testProbabilities();
+    std::printf("Solver tests passed\n");
+    return 0;
+}